@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Version.h>
+#include <MUtils/IPCChannel.h>
+
+//Qt
+#include <QCoreApplication>
+#include <QProcess>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QVector>
+
+//CRT
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+
+//===========================================================================
+// Constants
+//===========================================================================
+
+static const char *const APP_ID = "mutilities_bench";
+
+static const quint32 CMD_READY = 1;
+static const quint32 CMD_PING  = 2;
+static const quint32 CMD_DATA  = 3;
+static const quint32 CMD_END   = 4;
+static const quint32 CMD_QUIT  = 5;
+
+static const quint32 REPLY_TIMEOUT = 10000;
+static const quint32 WARMUP_ROUNDS = 100;
+static const quint32 DEFAULT_ROUNDS = 10000;
+static const quint32 DEFAULT_MESSAGES = 100000;
+
+typedef struct
+{
+	int mode;
+	const char *name;
+	quint32 maxPayload;
+}
+transport_t;
+
+static const transport_t TRANSPORTS[] =
+{
+	{ MUtils::IPCChannel::MODE_SEMAPHORE, "semaphore", MUtils::IPCChannel::MAX_PARAM_LEN - 1U },
+	{ MUtils::IPCChannel::MODE_RING,      "ring",      65536U },
+	{ MUtils::IPCChannel::MODE_BROADCAST, "broadcast", 960U },
+	{ -1, NULL, 0U }
+};
+
+static const quint32 PAYLOAD_SIZES[] = { 0U, 64U, 1024U, 4000U };
+static const quint32 BATCH_SIZES[]   = { 1U, 16U, 128U };
+
+//===========================================================================
+// Utilities
+//===========================================================================
+
+/*
+ * Wait for the next message with the given command. The "semaphore" mode does not support timed reads, but it never drops a message either.
+ */
+static bool wait_for(MUtils::IPCChannel &channel, const int mode, const quint32 expected, quint32 &flags)
+{
+	quint32 command;
+	QStringList params;
+	do
+	{
+		const bool success = (mode == MUtils::IPCChannel::MODE_SEMAPHORE) ? channel.read(command, flags, params) : channel.read(command, flags, params, REPLY_TIMEOUT);
+		if(!success)
+		{
+			qWarning("No reply from the child process!");
+			return false;
+		}
+	}
+	while(command != expected);
+	return true;
+}
+
+static double percentile(const QVector<qint64> &sorted, const double p)
+{
+	if(sorted.isEmpty())
+	{
+		return 0.0;
+	}
+	const int index = qBound(0, int(double(sorted.count()) * p), sorted.count() - 1);
+	return double(sorted[index]) / 1000.0;
+}
+
+static quint32 get_option(const QStringList &args, const QString &name, const quint32 defaultValue)
+{
+	const int index = args.indexOf(name);
+	if((index >= 0) && (index + 1 < args.count()))
+	{
+		bool ok = false;
+		const quint32 value = args[index + 1].toUInt(&ok);
+		if(ok && (value > 0U))
+		{
+			return value;
+		}
+	}
+	return defaultValue;
+}
+
+//===========================================================================
+// Child process
+//===========================================================================
+
+/*
+ * Echo every "ping" message and count the "data" messages, until the parent asks us to quit
+ */
+static int run_child(const int mode, const QString &channelId)
+{
+	MUtils::IPCChannel ping(APP_ID, 1, channelId + QLatin1String("_ping"), mode);
+	MUtils::IPCChannel pong(APP_ID, 1, channelId + QLatin1String("_pong"), mode);
+	if((ping.initialize() != MUtils::IPCChannel::RET_SUCCESS_SLAVE) || (pong.initialize() != MUtils::IPCChannel::RET_SUCCESS_SLAVE))
+	{
+		qWarning("Failed to attach to the IPC channels!");
+		return EXIT_FAILURE;
+	}
+
+	if(!pong.send(CMD_READY, 0))
+	{
+		return EXIT_FAILURE;
+	}
+
+	quint32 received = 0U;
+	QList<MUtils::IPCChannel::ipc_message_t> messages;
+	forever
+	{
+		if(!ping.readBatch(messages, 1024U))
+		{
+			continue;
+		}
+		for(QList<MUtils::IPCChannel::ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); iter++)
+		{
+			switch(iter->command)
+			{
+			case CMD_PING:
+				pong.send(CMD_PING, iter->flags, iter->params);
+				break;
+			case CMD_DATA:
+				received++;
+				break;
+			case CMD_END:
+				pong.send(CMD_END, received);
+				received = 0U;
+				break;
+			case CMD_QUIT:
+				return EXIT_SUCCESS;
+			}
+		}
+	}
+}
+
+//===========================================================================
+// Benchmark
+//===========================================================================
+
+static bool run_latency(MUtils::IPCChannel &ping, MUtils::IPCChannel &pong, const int mode, const QStringList &payload, const quint32 rounds, QVector<qint64> &samples)
+{
+	QElapsedTimer timer;
+	samples.clear();
+	samples.reserve(int(rounds));
+
+	for(quint32 i = 0; i < WARMUP_ROUNDS + rounds; ++i)
+	{
+		quint32 flags = 0U;
+		timer.start();
+		if(!ping.send(CMD_PING, i, payload))
+		{
+			return false;
+		}
+		do
+		{
+			if(!wait_for(pong, mode, CMD_PING, flags))
+			{
+				return false;
+			}
+		}
+		while(flags != i);
+		const qint64 elapsed = timer.nsecsElapsed();
+		if(i >= WARMUP_ROUNDS)
+		{
+			samples.append(elapsed);
+		}
+	}
+
+	std::sort(samples.begin(), samples.end());
+	return true;
+}
+
+static bool run_throughput(MUtils::IPCChannel &ping, MUtils::IPCChannel &pong, const int mode, const QStringList &payload, const quint32 batchSize, const quint32 count, double &rate, quint32 &sent, quint32 &delivered)
+{
+	QList<MUtils::IPCChannel::ipc_message_t> batch;
+	for(quint32 i = 0; i < batchSize; ++i)
+	{
+		MUtils::IPCChannel::ipc_message_t message;
+		message.command = CMD_DATA;
+		message.flags = i;
+		message.params = payload;
+		batch.append(message);
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	for(sent = 0U; sent < count; sent += batchSize)
+	{
+		if(!((batchSize > 1U) ? ping.sendBatch(batch) : ping.send(CMD_DATA, sent, payload)))
+		{
+			return false;
+		}
+	}
+
+	if((!ping.send(CMD_END, 0)) || (!wait_for(pong, mode, CMD_END, delivered)))
+	{
+		return false;
+	}
+
+	const qint64 elapsed = qMax(timer.nsecsElapsed(), Q_INT64_C(1));
+	rate = double(sent) * 1000000000.0 / double(elapsed);
+	return true;
+}
+
+/*
+ * Every transport is measured with a fresh pair of channels ("ping" for parent-to-child, "pong" for child-to-parent) and a fresh child process
+ */
+static bool run_transport(const transport_t &transport, const quint32 rounds, const quint32 count, bool &first)
+{
+	const QString channelId(QString("bench_%1").arg(MUtils::next_rand_str()));
+	MUtils::IPCChannel ping(APP_ID, 1, channelId + QLatin1String("_ping"), transport.mode);
+	MUtils::IPCChannel pong(APP_ID, 1, channelId + QLatin1String("_pong"), transport.mode);
+	if((ping.initialize() != MUtils::IPCChannel::RET_SUCCESS_MASTER) || (pong.initialize() != MUtils::IPCChannel::RET_SUCCESS_MASTER))
+	{
+		qWarning("Failed to create the IPC channels!");
+		return false;
+	}
+
+	QProcess child;
+	child.setProcessChannelMode(QProcess::ForwardedChannels);
+	child.start(QCoreApplication::applicationFilePath(), QStringList() << "--child" << QString::number(transport.mode) << channelId);
+	if(!child.waitForStarted())
+	{
+		qWarning("Failed to start the child process!");
+		return false;
+	}
+
+	quint32 dummy;
+	bool success = wait_for(pong, transport.mode, CMD_READY, dummy);
+	for(size_t i = 0; success && (i < MUTILS_ARR2LEN(PAYLOAD_SIZES)); ++i)
+	{
+		const quint32 payloadSize = PAYLOAD_SIZES[i];
+		if(payloadSize > transport.maxPayload)
+		{
+			continue;
+		}
+
+		const QStringList payload = (payloadSize > 0U) ? (QStringList() << QString(int(payloadSize), QLatin1Char('x'))) : QStringList();
+		QVector<qint64> samples;
+		success = run_latency(ping, pong, transport.mode, payload, rounds, samples);
+		if(!success)
+		{
+			break;
+		}
+
+		printf("%s\n    {\"transport\": \"%s\", \"payload\": %u, ", first ? "" : ",", transport.name, payloadSize);
+		printf("\"latency_us\": {\"rounds\": %u, \"p50\": %.3f, \"p99\": %.3f, \"p999\": %.3f}, \"throughput\": [", rounds, percentile(samples, 0.5), percentile(samples, 0.99), percentile(samples, 0.999));
+		first = false;
+
+		for(size_t j = 0; success && (j < MUTILS_ARR2LEN(BATCH_SIZES)); ++j)
+		{
+			double rate = 0.0;
+			quint32 sent = 0U, delivered = 0U;
+			success = run_throughput(ping, pong, transport.mode, payload, BATCH_SIZES[j], count, rate, sent, delivered);
+			if(success)
+			{
+				printf("%s{\"batch\": %u, \"sent\": %u, \"delivered\": %u, \"msgs_per_sec\": %.1f}", (j > 0) ? ", " : "", BATCH_SIZES[j], sent, delivered, rate);
+			}
+		}
+
+		printf("]}");
+		fflush(stdout);
+	}
+
+	ping.send(CMD_QUIT, 0);
+	if(!child.waitForFinished(REPLY_TIMEOUT))
+	{
+		child.kill();
+		child.waitForFinished();
+	}
+
+	return success;
+}
+
+//===========================================================================
+// Main function
+//===========================================================================
+
+/*
+ * Usage: MUtilitiesBench.exe [--transport <semaphore|ring|broadcast>] [--rounds <n>] [--messages <n>]
+ *
+ * The results are written to stdout in JSON format, all other output goes to stderr
+ */
+int main(int argc, char *argv[])
+{
+	QCoreApplication application(argc, argv);
+	const QStringList args = application.arguments();
+
+	const int childIndex = args.indexOf("--child");
+	if((childIndex >= 0) && (childIndex + 2 < args.count()))
+	{
+		return run_child(args[childIndex + 1].toInt(), args[childIndex + 2]);
+	}
+
+	fprintf(stderr, "MuldeR's Utilities for Qt v%u.%02u - IPC Benchmark [%s]\n", MUtils::Version::lib_version_major(), MUtils::Version::lib_version_minor(), MUTILS_DEBUG ? "DEBUG" : "RELEASE");
+	fprintf(stderr, "Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>. Some rights reserved.\n\n");
+
+	const quint32 rounds = get_option(args, "--rounds", DEFAULT_ROUNDS);
+	const quint32 count = get_option(args, "--messages", DEFAULT_MESSAGES);
+	const int transportIndex = args.indexOf("--transport");
+	const QString selected = ((transportIndex >= 0) && (transportIndex + 1 < args.count())) ? args[transportIndex + 1].toLower() : QString();
+
+	bool first = true, success = true;
+	printf("{\"version\": \"%u.%02u\", \"compiler\": \"%s\", \"arch\": \"%s\", \"results\": [", MUtils::Version::lib_version_major(), MUtils::Version::lib_version_minor(), MUtils::Version::compiler_version(), MUtils::Version::compiler_arch());
+	for(const transport_t *transport = TRANSPORTS; transport->name; transport++)
+	{
+		if(selected.isEmpty() || (selected.compare(QLatin1String(transport->name)) == 0))
+		{
+			fprintf(stderr, "Running \"%s\" transport...\n", transport->name);
+			if(!run_transport(*transport, rounds, count, first))
+			{
+				fprintf(stderr, "Benchmark of \"%s\" transport has failed!\n", transport->name);
+				success = false;
+			}
+		}
+	}
+	printf("\n]}\n");
+
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
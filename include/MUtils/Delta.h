@@ -0,0 +1,100 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains functions for generating and applying binary deltas ("rsync" algorithm)
+*
+* The *receiver* calls MUtils::Delta::signature() on its current version of a file (the "basis") and sends the signature to the *sender*. The *sender* calls MUtils::Delta::generate() to compute the delta between the basis and its own version of the file (the "target"). Finally, the *receiver* calls MUtils::Delta::apply() to reconstruct the target from the basis and the delta. Only the blocks that have changed need to be transferred.
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Hash.h>
+
+//Qt
+#include <QByteArray>
+
+//Forward Declarations
+class QIODevice;
+
+namespace MUtils
+{
+	/**
+	* \brief This namespace contains functions for generating and applying binary deltas
+	*
+	* Blocks are located by a rolling Adler-32 checksum, which can be updated in O(1) time when the window advances by one byte, and are confirmed by a strong signature computed with the MUtils::Hash functions.
+	*/
+	namespace Delta
+	{
+		static const quint32 DEFAULT_BLOCK_SIZE = 2048U;	///< \brief Default block size, in bytes
+		static const quint32 STRONG_HASH_LEN    = 16U;		///< \brief Length of the (truncated) strong signature that is stored for each block, in bytes
+
+		/**
+		* \brief Create the signature of a basis file
+		*
+		* This function splits the basis file into blocks of fixed size and computes a weak (rolling) checksum as well as a strong signature for each block.
+		*
+		* \param basis A reference to a QIODevice object holding the basis data. The device must be open and readable. All data from the current position to the end of the device will be processed.
+		*
+		* \param signature A reference to a QByteArray object that receives the signature data.
+		*
+		* \param blockSize The block size, in bytes. Smaller blocks result in smaller deltas, but in larger signatures.
+		*
+		* \param hashId Specifies the hash function for the strong signatures. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file; otherwise the function fails.
+		*
+		* \return The function returns `true`, if the signature was created successfully; otherwise it returns `false`.
+		*/
+		MUTILS_API bool signature(QIODevice &basis, QByteArray &signature, const quint32 blockSize = DEFAULT_BLOCK_SIZE, const quint16 hashId = MUtils::Hash::HASH_BLAKE2_512);
+
+		/**
+		* \brief Generate a delta
+		*
+		* This function computes the delta that transforms the basis, as described by the given signature, into the target. Blocks of the target that also exist *anywhere* in the basis are encoded as references; all other data is encoded as literal bytes. The target is processed in a streaming fashion, so it does **not** need to fit into memory.
+		*
+		* \param signature A read-only reference to a QByteArray object holding the signature of the basis, as created by the signature() function.
+		*
+		* \param target A reference to a QIODevice object holding the target data. The device must be open and readable.
+		*
+		* \param delta A reference to a QIODevice object that receives the delta data. The device must be open and writable.
+		*
+		* \return The function returns `true`, if the delta was generated successfully; otherwise it returns `false`.
+		*/
+		MUTILS_API bool generate(const QByteArray &signature, QIODevice &target, QIODevice &delta);
+
+		/**
+		* \brief Apply a delta
+		*
+		* This function reconstructs the target from the basis and the given delta. The result is verified against the digest of the target that is stored in the delta.
+		*
+		* \param basis A reference to a QIODevice object holding the basis data. The device must be open, readable and *random-access* (e.g. a QFile or QBuffer).
+		*
+		* \param delta A reference to a QIODevice object holding the delta data, as created by the generate() function. The device must be open and readable.
+		*
+		* \param output A reference to a QIODevice object that receives the reconstructed target data. The device must be open and writable.
+		*
+		* \return The function returns `true`, if the delta was applied *and* verified successfully; otherwise it returns `false`.
+		*/
+		MUTILS_API bool apply(QIODevice &basis, QIODevice &delta, QIODevice &output);
+	}
+}
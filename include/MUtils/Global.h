@@ -31,6 +31,7 @@
 //Forward Declarations
 class QProcess;
 class QDir;
+class QFile;
 template<typename K, typename V> class QHash;
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -132,21 +133,42 @@ namespace MUtils
 	/**
 	* \brief Generates a *random* unsigned 32-Bit value.
 	*
-	* The *random* value is created using a "strong" PRNG of the underlying system, if possible. Otherwise a fallback PRNG is used. It is **not** required or useful to call `srand()` or `qsrand()` prior to using this function. If necessary, the seeding of the PRNG happen *automatically* on the first call.
+	* The *random* value is created using a per-thread ChaCha20 generator, which is seeded from the "strong" PRNG of the underlying system, if possible. Otherwise a fallback PRNG is used for seeding. It is **not** required or useful to call `srand()` or `qsrand()` prior to using this function. If necessary, the seeding of the PRNG happen *automatically* on the first call in each thread.
 	*
 	* \return The function returns a *random* unsigned 32-Bit value.
 	*/
 	MUTILS_API quint32 next_rand_u32(void);
+
+	/**
+	* \brief Generates a *random* unsigned 32-Bit value in the range from 0 to `max-1`.
+	*
+	* The *random* value is created using the same PRNG as the `next_rand_u32(void)` function. All values in the range are equally likely, i.e. there is **no** modulo bias.
+	*
+	* \param max The upper bound (exclusive) of the random value. If this parameter is `0`, the function returns `0`.
+	*
+	* \return The function returns a *random* unsigned 32-Bit value in the range from 0 to `max-1`.
+	*/
 	MUTILS_API quint32 next_rand_u32(const quint32 max);
 
 	/**
 	* \brief Generates a *random* unsigned 64-Bit value.
 	*
-	* The *random* value is created using a "strong" PRNG of the underlying system, if possible. Otherwise a fallback PRNG is used. It is **not** required or useful to call `srand()` or `qsrand()` prior to using this function. If necessary, the seeding of the PRNG happen *automatically* on the first call.
+	* The *random* value is created using the same PRNG as the `next_rand_u32(void)` function.
 	*
 	* \return The function returns a *random* unsigned 64-Bit value.
 	*/
 	MUTILS_API quint64 next_rand_u64(void);
+
+	/**
+	* \brief Fills a buffer with *random* bytes.
+	*
+	* The *random* bytes are created using the same PRNG as the `next_rand_u32(void)` function. This is much faster than calling `next_rand_u32()` repeatedly.
+	*
+	* \param buffer A pointer to the buffer that receives the random bytes.
+	*
+	* \param size The size of the buffer, in bytes.
+	*/
+	MUTILS_API void next_rand_bytes(void *const buffer, const size_t size);
 	
 	/**
 	* \brief Generates a *random* string.
@@ -168,13 +190,43 @@ namespace MUtils
 	*
 	* \param extension Specifies the desired file extensions of the temporary file. Do **not** include a leading dot (`.`) character.
 	*
-	* \param placeholder If set to `true`, the function creates an empty "placeholder" file under the returned file name; if set to `false`, it does *not*.
+	* \param placeholder If set to `true`, the function creates an empty "placeholder" file under the returned file name; if set to `false`, it does *not*. The placeholder file is created *atomically*, i.e. it is guaranteed that no other thread or process has created a file of the same name in the meantime. Without a placeholder, the file name may have been taken by the time the caller creates the file!
 	*
 	* \return If the function succeeds, it returns a QString holding the full path of the temporary file; otherwise it returns a default-constructed QString.
 	*/
 	MUTILS_API QString make_temp_file(const QString &basePath, const QString &extension, const bool placeholder = false);
 	MUTILS_API QString make_temp_file(const QDir    &basePath, const QString &extension, const bool placeholder = false);
 
+	/**
+	* \brief Creates and opens a new temporary file.
+	*
+	* The function creates a new, empty file following the `"<basedir>/<random>.<ext>"` pattern and returns it *open* for reading and writing. Checking that the file does not exist yet and creating the file is a *single* atomic operation (exclusive creation), so no other thread or process can take the same file name. Also, no separate "stat" call is required per attempt.
+	*
+	* \param file A reference to the QFile object that receives the temporary file. The QFile object must *not* be open yet. On success, its file name is set to the full path of the temporary file and it is opened in `QIODevice::ReadWrite` mode. The caller is responsible for deleting the file, when it is no longer needed.
+	*
+	* \param basePath Specifies the "base" directory where the temporary file is created. This must be a valid *existing* directory.
+	*
+	* \param extension Specifies the desired file extensions of the temporary file. Do **not** include a leading dot (`.`) character.
+	*
+	* \return The function returns `true`, if the temporary file was created and opened successfully; otherwise it returns `false`.
+	*/
+	MUTILS_API bool make_temp_file(QFile &file, const QDir &basePath, const QString &extension);
+
+	/**
+	* \brief Reserves a batch of new temporary files.
+	*
+	* The function creates the specified number of new, empty files following the `"<basedir>/<random>.<ext>"` pattern. Each file is created *atomically*, as described for the make_temp_file() function, and then closed again. The base directory is resolved only *once* for the whole batch, and no separate "stat" calls are required, which matters on network drives. The caller is responsible for deleting the files, when they are no longer needed.
+	*
+	* \param basePath Specifies the "base" directory where the temporary files are created. This must be a valid *existing* directory.
+	*
+	* \param extension Specifies the desired file extensions of the temporary files. Do **not** include a leading dot (`.`) character.
+	*
+	* \param count Specifies the number of temporary files to be created.
+	*
+	* \return If the function succeeds, it returns a QStringList holding the full paths of the `count` temporary files; otherwise it returns an empty QStringList. On failure, files that have already been created by this call are removed again.
+	*/
+	MUTILS_API QStringList make_temp_files(const QDir &basePath, const QString &extension, const quint32 count);
+
 	/**
 	* \brief Generates a unique file name.
 	*
@@ -270,6 +322,28 @@ namespace MUtils
 	*/
 	MUTILS_API QString trim_left(const QString &str);
 
+	/**
+	* \brief Remove *trailing* white-space characters from all strings in a list
+	*
+	* The function removes all *trailing* white-space characters from each string in the specified list, as if `trim_right()` was called on each string. Strings that do *not* have any trailing white-space characters are left untouched, i.e. they are **not** copied or reallocated.
+	*
+	* \param list A reference to the QStringList object to be trimmed. This QStringList object will be modified directly.
+	*
+	* \return A reference to the trimmed QStringList object. This is the same QStringList object that was specified in the `list` parameter.
+	*/
+	MUTILS_API QStringList& trim_right(QStringList &list);
+
+	/**
+	* \brief Remove *leading* white-space characters from all strings in a list
+	*
+	* The function removes all *leading* white-space characters from each string in the specified list, as if `trim_left()` was called on each string. Strings that do *not* have any leading white-space characters are left untouched, i.e. they are **not** copied or reallocated.
+	*
+	* \param list A reference to the QStringList object to be trimmed. This QStringList object will be modified directly.
+	*
+	* \return A reference to the trimmed QStringList object. This is the same QStringList object that was specified in the `list` parameter.
+	*/
+	MUTILS_API QStringList& trim_left(QStringList &list);
+
 	/**
 	* \brief Sort a list of strings using "natural ordering" algorithm
 	*
@@ -281,6 +355,19 @@ namespace MUtils
 	*/
 	MUTILS_API void natural_string_sort(QStringList &list, const bool bIgnoreCase);
 
+	/**
+	* \brief Compute the "natural ordering" sort key of a string
+	*
+	* This function converts the given string into a binary sort key. Comparing two sort keys with `memcmp()`, where the shorter key sorts first if one key is a prefix of the other, yields the same order as natural_string_sort(). Ties between strings that are equal in "natural" order are broken by the raw UTF-16 code units, so the order is strict. Computing the keys once is much faster than comparing strings repeatedly, e.g. when maintaining a sorted index.
+	*
+	* \param str A read-only reference to the QString object for which the sort key is computed.
+	*
+	* \param bIgnoreCase If set to `true`, the character case is disregarded in the "natural" order (but still used as a tie-breaker); if set to `false`, the character case *is* taken into account.
+	*
+	* \return Returns a QByteArray containing the sort key.
+	*/
+	MUTILS_API QByteArray natural_sort_key(const QString &str, const bool bIgnoreCase);
+
 	/**
 	* \brief Clean up a file name string
 	*
@@ -294,6 +381,19 @@ namespace MUtils
 	*/
 	MUTILS_API QString clean_file_name(const QString &name, const bool &pretty);
 
+	/**
+	* \brief Clean up a list of file name strings
+	*
+	* This function cleans up each string in the specified list, as if `clean_file_name()` was called on each string. Strings that are valid file names already are left untouched, i.e. they are **not** copied or reallocated. This function does *not* take any global locks, so it can be called from many threads concurrently.
+	*
+	* \param names A reference to the QStringList object holding the original, potentially invalid file names. This QStringList object will be modified directly.
+	*
+	* \param pretty If set to `true`, the function tries to generate "pretty" file names. Otherwise, the function simply replaces each forbidden file name character by an underscore character.
+	*
+	* \return A reference to the modified QStringList object. This is the same QStringList object that was specified in the `names` parameter.
+	*/
+	MUTILS_API QStringList& clean_file_name(QStringList &names, const bool &pretty);
+
 	/**
 	* \brief Clean up a file path string
 	*
@@ -105,10 +105,20 @@ namespace MUtils
 			*/
 			QByteArray digest(const bool bAsHex = true) { return bAsHex ? finalize().toHex() : finalize(); }
 
+			/**
+			* \brief Reset the hash function
+			*
+			* Restores the initial state of the hash function (including the key, if any), so that the *same* Hash instance can be used to compute another hash value. This avoids creating a new Hash instance for each hash value, when many small inputs are processed.
+			*
+			* \return The function returns `true`, if the hash function was reset successfully; otherwise it returns `false`.
+			*/
+			bool reset(void) { return restart(); }
+
 		protected:
 			Hash(const char* /*key*/ = NULL) {/*nothing to do*/};
 			virtual bool process(const quint8 *const data, const quint32 len) = 0;
 			virtual QByteArray finalize(void) = 0;
+			virtual bool restart(void) = 0;
 
 		private:
 			MUTILS_NO_COPY(Hash);
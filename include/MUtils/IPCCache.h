@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains the IPCCache class for sharing key/value pairs between processes
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/IPCChannel.h>
+
+//Qt
+#include <QByteArray>
+
+namespace MUtils
+{
+	class MUTILS_API IPCCache_Private;
+
+	/**
+	* \brief This class implements a key/value cache in shared memory
+	*
+	* All processes that use the *same* parameters share the same cache, so an expensive result needs to be computed only once per machine. The cache has a fixed number of buckets; when all buckets that a key can be stored in are occupied, the (approximately) least-recently used entry is evicted.
+	*
+	* Lookups are *lock-free*: each bucket is protected by a sequence lock, so readers never block writers or each other. A hit does not modify any shared counter. Modifications are serialized by a named mutex.
+	*/
+	class MUTILS_API IPCCache
+	{
+	public:
+		static const quint32 MAX_KEY_LEN = 256U;		///< \brief Maximum length of a key, in bytes
+		static const quint32 MAX_VALUE_LEN = 1024U;		///< \brief Maximum length of a value, in bytes
+		static const quint32 BUCKET_COUNT = 4096U;		///< \brief Total number of buckets, i.e. the maximum number of entries
+
+		/**
+		* \brief Create a new IPCCache instance
+		*
+		* The parameters have the same meaning as for the MUtils::IPCChannel class. All instances using the *same* parameters will be connected to the same cache.
+		*/
+		IPCCache(const QString &applicationId, const quint32 &appVersionNo, const QString &cacheId);
+
+		/**
+		* \brief Destroys the IPCCache instance
+		*/
+		~IPCCache(void);
+
+		/**
+		* \brief Initialize the cache
+		*
+		* This function *must* be called before the cache can be used. The first instance that calls this function creates the shared memory ("master"), all further instances will attach to the existing shared memory ("slave").
+		*
+		* \return The function returns one of the MUtils::IPCChannel::ipc_result_t values.
+		*/
+		int initialize(void);
+
+		/**
+		* \brief Look up a value
+		*
+		* \param key A read-only reference to a QByteArray object holding the key. The key must *not* be empty and must *not* exceed MAX_KEY_LEN bytes.
+		*
+		* \param value A reference to a QByteArray object that receives the value, if the key was found.
+		*
+		* \return The function returns `true`, if the key was found; otherwise it returns `false`.
+		*/
+		bool lookup(const QByteArray &key, QByteArray &value) const;
+
+		/**
+		* \brief Insert or replace a value
+		*
+		* If the cache is full, the least-recently used entry among the entries that compete for the same buckets is evicted.
+		*
+		* \param key A read-only reference to a QByteArray object holding the key. The key must *not* be empty and must *not* exceed MAX_KEY_LEN bytes.
+		*
+		* \param value A read-only reference to a QByteArray object holding the value. The value must *not* exceed MAX_VALUE_LEN bytes.
+		*
+		* \return The function returns `true`, if the value was stored successfully; otherwise it returns `false`.
+		*/
+		bool insert(const QByteArray &key, const QByteArray &value);
+
+		/**
+		* \brief Remove a value
+		*
+		* \return The function returns `true`, if the key was found and removed; otherwise it returns `false`.
+		*/
+		bool remove(const QByteArray &key);
+
+	private:
+		IPCCache(const IPCCache&) : p(NULL), m_appVersionNo((unsigned int)(-1)) { throw "Constructor is disabled!"; }
+		IPCCache &operator=(const IPCCache&) { throw "Assignment operator is disabled!"; }
+
+		const QString m_applicationId;
+		const QString m_cacheId;
+		const unsigned int m_appVersionNo;
+		const QByteArray m_headerStr;
+
+		IPCCache_Private *const p;
+	};
+}
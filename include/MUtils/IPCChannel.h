@@ -31,6 +31,35 @@
 namespace MUtils
 {
 	class MUTILS_API IPCChannel_Private;
+	class MUTILS_API IPCNotifier;
+	class MUTILS_API IPCPayload;
+
+	class MUTILS_API IPCMessageView
+	{
+	public:
+		IPCMessageView(void);
+		~IPCMessageView(void);
+
+		void release(void);
+
+		bool isValid(void) const { return (m_ring != NULL); }
+		quint32 command(void) const;
+		quint32 flags(void) const;
+		quint32 paramCount(void) const;
+		const char *param(const quint32 &index, quint32 &length) const;
+
+	private:
+		friend class IPCChannel;
+		MUTILS_NO_COPY(IPCMessageView)
+
+		void *m_ring;
+		quint32 m_position;
+		quint32 m_length;
+		quint32 m_cells;
+		const quint8 *m_data;
+		mutable quint32 m_cursorIndex;
+		mutable quint32 m_cursorOffset;
+	};
 
 	class MUTILS_API IPCChannel
 	{
@@ -47,21 +76,67 @@ namespace MUtils
 		}
 		ipc_result_t;
 
-		IPCChannel(const QString &applicationId, const quint32 &versionNo, const QString &channelId);
+		typedef enum
+		{
+			MODE_SEMAPHORE = 0,
+			MODE_RING = 1,
+			MODE_BROADCAST = 2,
+			MODE_PIPE = 3
+		}
+		ipc_mode_t;
+
+		typedef enum
+		{
+			PRIORITY_NORMAL = 0,
+			PRIORITY_HIGH = 1,
+			PRIORITY_URGENT = 2
+		}
+		ipc_priority_t;
+
+		typedef struct
+		{
+			quint32 command;
+			quint32 flags;
+			QStringList params;
+		}
+		ipc_message_t;
+
+		IPCChannel(const QString &applicationId, const quint32 &versionNo, const QString &channelId, const int &mode = MODE_SEMAPHORE);
 		~IPCChannel(void);
 
 		int initialize(void);
 
 		bool send(const quint32 &command, const quint32 &flags, const QStringList &params = QStringList());
+		bool send(const quint32 &command, const quint32 &flags, const QStringList &params, const int &priority);
 		bool read(quint32 &command, quint32 &flags, QStringList &params);
+		bool read(quint32 &command, quint32 &flags, QStringList &params, const quint32 &timeout);
+		bool tryRead(quint32 &command, quint32 &flags, QStringList &params);
+
+		bool sendBatch(const QList<ipc_message_t> &messages);
+		bool readBatch(QList<ipc_message_t> &messages, const quint32 &maxCount);
+
+		bool readView(IPCMessageView &view);
+		bool readView(IPCMessageView &view, const quint32 &timeout);
+
+		bool sendPayload(const quint32 &command, const quint32 &flags, const IPCPayload &payload);
+		bool sendPayload(const quint32 &command, const quint32 &flags, const IPCPayload &payload, const quint32 &timeout);
+		bool readPayload(quint32 &command, quint32 &flags, IPCPayload &payload);
+		bool readPayload(quint32 &command, quint32 &flags, IPCPayload &payload, const quint32 &timeout);
+		quint32 maxPayloadSize(void) const;
+
+		bool sendHandle(const quint32 &command, const quint32 &flags, const QStringList &params, void *const handle);
+		bool readHandle(quint32 &command, quint32 &flags, QStringList &params, void *&handle);
 
 	private:
-		IPCChannel(const IPCChannel&) : p(NULL), m_appVersionNo((unsigned int)(-1)) { throw "Constructor is disabled!"; }
+		friend class IPCNotifier;
+
+		IPCChannel(const IPCChannel&) : p(NULL), m_appVersionNo((unsigned int)(-1)), m_mode(-1) { throw "Constructor is disabled!"; }
 		IPCChannel &operator=(const IPCChannel&) { throw "Assignment operator is disabled!"; }
 
 		const QString m_applicationId;
 		const QString m_channelId;
 		const unsigned int m_appVersionNo;
+		const int m_mode;
 		const QByteArray m_headerStr;
 
 		IPCChannel_Private *const p;
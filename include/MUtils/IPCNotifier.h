@@ -0,0 +1,61 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/IPCChannel.h>
+
+//Qt
+#include <QObject>
+
+class QWinEventNotifier;
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class MUTILS_API IPCNotifier : public QObject
+	{
+		Q_OBJECT
+
+	public:
+		IPCNotifier(IPCChannel &channel, QObject *const parent = NULL);
+		~IPCNotifier(void);
+
+	signals:
+		void messagesPending(void);
+
+	private slots:
+		void eventActivated(void);
+
+	private:
+		friend class IPCChannel;
+
+		bool isPending(void) const;
+
+		IPCChannel *m_channel;
+		QWinEventNotifier *m_notifier;
+		void *m_event;
+		quint32 m_slot;
+	};
+}
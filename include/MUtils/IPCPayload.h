@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains the IPCPayload class for encoding and decoding typed IPC messages
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QByteArray>
+#include <QStringList>
+
+namespace MUtils
+{
+	/**
+	* \brief This class implements a compact, typed payload for IPC messages
+	*
+	* The payload is a sequence of elements in tag-length-value encoding. Integers are stored as "zig-zag" variable-length integers, doubles are stored in their binary representation, byte arrays and strings are stored *unmodified* (strings as UTF-8). Hence, numbers don't need to be converted to text and back again.
+	*
+	* The elements are appended with the `put` functions and are read back, in the same order, with the `get` functions. Typed payloads can be sent with MUtils::IPCChannel::sendPayload() and received with MUtils::IPCChannel::readPayload().
+	*/
+	class MUTILS_API IPCPayload
+	{
+	public:
+		/**
+		* \brief Element types
+		*/
+		typedef enum
+		{
+			TYPE_NONE = 0,		///< \brief No more elements (or malformed data)
+			TYPE_INT = 1,		///< \brief Signed 64-Bit integer
+			TYPE_DOUBLE = 2,	///< \brief Double-precision floating point value
+			TYPE_BYTES = 3,		///< \brief Byte array
+			TYPE_STRINGS = 4	///< \brief List of strings
+		}
+		payload_type_t;
+
+		/**
+		* \brief Create a new, empty payload
+		*/
+		IPCPayload(void);
+
+		/**
+		* \brief Create a payload from existing (encoded) data
+		*
+		* \param data A read-only reference to a QByteArray object holding the encoded payload, as returned by the data() function.
+		*/
+		explicit IPCPayload(const QByteArray &data);
+
+		/**
+		* \brief Remove all elements and reset the read position
+		*/
+		void clear(void);
+
+		/**
+		* \brief Reset the read position to the first element
+		*/
+		inline void rewind(void) { m_cursor = 0; }
+
+		/**
+		* \brief Get the encoded payload data
+		*/
+		inline const QByteArray &data(void) const { return m_data; }
+
+		/**
+		* \brief Append an integer value
+		*/
+		void putInt(const qint64 &value);
+
+		/**
+		* \brief Append a double value
+		*/
+		void putDouble(const double &value);
+
+		/**
+		* \brief Append a byte array
+		*/
+		void putBytes(const QByteArray &value);
+
+		/**
+		* \brief Append a byte array, given as pointer and length
+		*/
+		void putBytes(const char *const data, const quint32 &length);
+
+		/**
+		* \brief Append a list of strings
+		*
+		* Each string is encoded to UTF-8 *directly* into the payload.
+		*/
+		void putStrings(const QStringList &value);
+
+		/**
+		* \brief Get the type of the next element
+		*
+		* \return The function returns one of the payload_type_t values. It returns `TYPE_NONE`, if there are no more elements or if the next element is malformed. Elements of an *unknown* type are skipped.
+		*/
+		int nextType(void);
+
+		/**
+		* \brief Read the next element as an integer value
+		*
+		* \return The function returns `true`, if the next element is an integer and was read successfully; otherwise it returns `false` and the read position remains unchanged.
+		*/
+		bool getInt(qint64 &value);
+
+		/**
+		* \brief Read the next element as a double value
+		*
+		* \return The function returns `true`, if the next element is a double and was read successfully; otherwise it returns `false` and the read position remains unchanged.
+		*/
+		bool getDouble(double &value);
+
+		/**
+		* \brief Read the next element as a byte array
+		*
+		* \return The function returns `true`, if the next element is a byte array and was read successfully; otherwise it returns `false` and the read position remains unchanged.
+		*/
+		bool getBytes(QByteArray &value);
+
+		/**
+		* \brief Read the next element as a byte array, *without* copying the data
+		*
+		* \param data A reference to a pointer that receives the address of the data inside of the payload. The pointer remains valid as long as the payload is not modified or destroyed.
+		*
+		* \param length A reference to a variable that receives the length of the data, in bytes.
+		*
+		* \return The function returns `true`, if the next element is a byte array and was read successfully; otherwise it returns `false` and the read position remains unchanged.
+		*/
+		bool getBytes(const char *&data, quint32 &length);
+
+		/**
+		* \brief Read the next element as a list of strings
+		*
+		* \return The function returns `true`, if the next element is a list of strings and was read successfully; otherwise it returns `false` and the read position remains unchanged.
+		*/
+		bool getStrings(QStringList &value);
+
+	private:
+		bool getElement(const int &type, const quint8 *&data, quint32 &length);
+
+		QByteArray m_data;
+		int m_cursor;
+	};
+}
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains the IPCStream class for transferring binary data of arbitrary size between processes
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/IPCChannel.h>
+
+//Qt
+#include <QByteArray>
+
+//Forward Declarations
+class QIODevice;
+
+namespace MUtils
+{
+	class MUTILS_API IPCStream_Private;
+
+	/**
+	* \brief This class implements a channel for streaming binary data ("blobs") between processes
+	*
+	* Each blob is split into chunks, which are passed through a ring buffer in shared memory. The writer blocks while the ring buffer is full, so the reader controls the data rate. No temporary files are required.
+	*
+	* Multiple readers and writers may use the same channel; blobs are transferred one after another, i.e. a blob is always received *completely* by a single reader.
+	*/
+	class MUTILS_API IPCStream
+	{
+	public:
+		static const quint32 CHUNK_SIZE = 262144U;	///< \brief Maximum number of payload bytes per chunk
+
+		/**
+		* \brief Create a new IPCStream instance
+		*
+		* The parameters have the same meaning as for the MUtils::IPCChannel class. All instances using the *same* parameters will be connected to the same stream.
+		*/
+		IPCStream(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId);
+
+		/**
+		* \brief Destroys the IPCStream instance
+		*/
+		~IPCStream(void);
+
+		/**
+		* \brief Initialize the stream
+		*
+		* This function *must* be called before the stream can be used. The first instance that calls this function creates the shared memory ("master"), all further instances will attach to the existing shared memory ("slave").
+		*
+		* \return The function returns one of the MUtils::IPCChannel::ipc_result_t values.
+		*/
+		int initialize(void);
+
+		/**
+		* \brief Write a blob
+		*
+		* \param tag An application-defined value that is passed to the reader along with the blob.
+		*
+		* \param data A read-only reference to a QByteArray object holding the data to be written.
+		*
+		* \return The function returns `true`, if the blob was written successfully; otherwise it returns `false`.
+		*/
+		bool write(const quint32 &tag, const QByteArray &data);
+
+		/**
+		* \brief Write a blob from a QIODevice
+		*
+		* \param tag An application-defined value that is passed to the reader along with the blob.
+		*
+		* \param input A reference to a QIODevice object. The device must be open and readable. All data from the current position to the end of the device will be written, so the size of the blob is *not* limited by the available memory. For a sequential device (e.g. QProcess or a socket), this function waits for more data until the source has been closed.
+		*
+		* \return The function returns `true`, if the blob was written successfully; otherwise it returns `false`.
+		*/
+		bool write(const quint32 &tag, QIODevice &input);
+
+		/**
+		* \brief Read the next blob
+		*
+		* This function blocks until a blob is available.
+		*
+		* \param tag A reference to a variable that receives the tag of the blob.
+		*
+		* \param data A reference to a QByteArray object that receives the data of the blob.
+		*
+		* \return The function returns `true`, if a blob was read successfully; otherwise it returns `false`.
+		*/
+		bool read(quint32 &tag, QByteArray &data);
+
+		/**
+		* \brief Read the next blob into a QIODevice
+		*
+		* This function blocks until a blob is available. The data is written to the device chunk by chunk, so the size of the blob is *not* limited by the available memory.
+		*
+		* \param tag A reference to a variable that receives the tag of the blob.
+		*
+		* \param output A reference to a QIODevice object that receives the data of the blob. The device must be open and writable.
+		*
+		* \return The function returns `true`, if a blob was read successfully; otherwise it returns `false`.
+		*/
+		bool read(quint32 &tag, QIODevice &output);
+
+	private:
+		IPCStream(const IPCStream&) : p(NULL), m_appVersionNo((unsigned int)(-1)) { throw "Constructor is disabled!"; }
+		IPCStream &operator=(const IPCStream&) { throw "Assignment operator is disabled!"; }
+
+		bool writeChunks(const quint32 &tag, const char *const data, QIODevice *const input, const quint64 &total);
+		bool readChunks(quint32 &tag, QByteArray *const data, QIODevice *const output);
+
+		const QString m_applicationId;
+		const QString m_channelId;
+		const unsigned int m_appVersionNo;
+		const QByteArray m_headerStr;
+
+		IPCStream_Private *const p;
+	};
+}
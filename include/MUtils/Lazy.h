@@ -21,7 +21,7 @@
 
 /**
 * @file
-* @brief This file contains a template class for lazy initialization
+* @brief This file contains template classes for lazy initialization and for cached values
 */
 
 #pragma once
@@ -31,26 +31,70 @@
 #include <MUtils/Exception.h>
 
 //Qt
-#include <QThread>
 #include <QAtomicPointer>
 #include <QAtomicInt>
+#include <QMutex>
+#include <QThread>
+#include <QElapsedTimer>
 
 //CRT
 #include <functional>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 namespace MUtils
 {
+	namespace Internal
+	{
+		static const int LAZY_IDLE = 0;		//not initialized yet
+		static const int LAZY_BUSY = 1;		//initializer is running
+		static const int LAZY_WAIT = 2;		//initializer is running, other threads are waiting
+		static const int LAZY_DONE = 3;		//initialized
+
+		static const int LAZY_TASK_NONE = 0;	//no prefetch task was started
+		static const int LAZY_TASK_PEND = 1;	//prefetch task is queued or running
+		static const int LAZY_TASK_DONE = 2;	//prefetch task has completed
+
+		MUTILS_API bool lazy_begin(QAtomicInt &state);
+		MUTILS_API void lazy_end(QAtomicInt &state, const bool success);
+
+		MUTILS_API void lazy_prefetch(QAtomicInt &task, const std::function<void(void)> &work);
+		MUTILS_API void lazy_join(QAtomicInt &task);
+	}
+
 	/**
 	* \brief Lazy initialization template class
 	*
 	* The lazy-initialized value of type T can be obtained from a `Lazy<T>` instance by using the `operator*()`. Initialization of the value happens when the `operator*()` is called for the very first time, by invoking the `initializer` lambda-function that was passed to the constructor. The return value of the `initializer` lambda-function is then stored internally, so that any subsequent call to the `operator*()` *immediately* returns the previously created value.
 	*
-	* **Note on thread-saftey:** This class is thread-safe in the sense that all calls to `operator*()` on the same `Lazy<T>` instance, regardless from which thread, are guaranteed to return the exactly same value/object. The *first* thread trying to access the value will invoke the `initializer` lambda-function; concurrent threads may need to busy-wait until the initialization is completed. The `initializer` lambda-function is invoked at most once.
+	* **Note on thread-saftey:** This class is thread-safe in the sense that all calls to `operator*()` on the same `Lazy<T>` instance, regardless from which thread, are guaranteed to return the exactly same value/object. The *first* thread trying to access the value will invoke the `initializer` lambda-function; concurrent threads spin for a short while and then *sleep* until the initialization is completed. The `initializer` lambda-function is invoked at most once, unless it fails (returns `NULL` or throws), in which case the next access will try again.
+	*
+	* **Prefetching:** The initialization can be started ahead of time, on a background thread, by calling `prefetch()` or by passing `true` for the `prefetch` parameter of the constructor. A subsequent call to `operator*()` then only waits for the remaining work, if any. The destructor waits for a pending prefetch task to complete.
 	*/
 	template<typename T> class Lazy
 	{
 	public:
-		Lazy(std::function<T*(void)> &&initializer) : m_initializer(initializer) { }
+		Lazy(std::function<T*(void)> &&initializer, const bool prefetch = false) : m_initializer(initializer)
+		{
+			if (prefetch)
+			{
+				this->prefetch();
+			}
+		}
+
+		/**
+		* \brief Start the initialization on a background thread
+		*
+		* The `initializer` lambda-function is invoked on a thread of the global QThreadPool, unless the value has already been initialized or a prefetch task has already been started. Exceptions thrown by the `initializer` are ignored here; they will be thrown (again) by the next call to `operator*()`.
+		*/
+		void prefetch(void)
+		{
+			if (m_state != Internal::LAZY_DONE)
+			{
+				Internal::lazy_prefetch(m_task, [this]() { this->initialize(); });
+			}
+		}
 
 		T& operator*(void)
 		{
@@ -64,11 +108,12 @@ namespace MUtils
 
 		bool initialized()
 		{
-			return (m_state > 1);
+			return (m_state == Internal::LAZY_DONE);
 		}
 
 		~Lazy(void)
 		{
+			Internal::lazy_join(m_task);
 			if(T *const value = m_value)
 			{
 				delete value;
@@ -78,28 +123,400 @@ namespace MUtils
 	protected:
 		__forceinline T* getValue()
 		{
-			T *value;
-			while (!(value = m_value))
+			if (T *const value = m_value)
+			{
+				return value; /*fast path*/
+			}
+			return initialize();
+		}
+
+		T* initialize()
+		{
+			if (Internal::lazy_begin(m_state))
 			{
-				if (m_state.testAndSetOrdered(0, 1))
+				T *value = NULL;
+				try
+				{
+					value = m_initializer();
+				}
+				catch (...)
+				{
+					Internal::lazy_end(m_state, false);
+					throw;
+				}
+				if (!value)
 				{
-					if (value = m_initializer())
-					{
-						m_value.fetchAndStoreOrdered(value);
-						m_state.fetchAndStoreOrdered(2);
-						break; /*success*/
-					}
-					m_state.fetchAndStoreOrdered(0);
+					Internal::lazy_end(m_state, false);
 					MUTILS_THROW("Initializer returned NULL pointer!");
 				}
-				QThread::yieldCurrentThread();
+				m_value.fetchAndStoreOrdered(value);
+				Internal::lazy_end(m_state, true);
 			}
-			return value;
+			return m_value;
 		}
 
 	private:
 		QAtomicPointer<T> m_value;
-		QAtomicInt m_state;
+		QAtomicInt m_state, m_task;
 		const std::function<T*(void)> m_initializer;
 	};
+
+	/**
+	* \brief Lazy initialization template class with inline storage
+	*
+	* This class works like `Lazy<T>`, except that the value is stored *inside* of the `LazyValue<T>` instance, rather than on the heap. The value is constructed in place from the return value of the `initializer` lambda-function, when it is accessed for the very first time, and it is destroyed together with the `LazyValue<T>` instance.
+	*
+	* Once the value has been initialized, accessing it takes a single memory load and a comparison; the `initializer` is never called again.
+	*/
+	template<typename T> class LazyValue
+	{
+	public:
+		LazyValue(std::function<T(void)> &&initializer, const bool prefetch = false) : m_initializer(initializer)
+		{
+			if (prefetch)
+			{
+				this->prefetch();
+			}
+		}
+
+		/**
+		* \brief Start the initialization on a background thread
+		*
+		* See `Lazy<T>::prefetch()` for details.
+		*/
+		void prefetch(void)
+		{
+			if (m_state != Internal::LAZY_DONE)
+			{
+				Internal::lazy_prefetch(m_task, [this]() { this->initialize(); });
+			}
+		}
+
+		T& operator*(void)
+		{
+			return (*getValue());
+		}
+
+		T* operator->(void)
+		{
+			return getValue();
+		}
+
+		bool initialized()
+		{
+			return (m_state == Internal::LAZY_DONE);
+		}
+
+		~LazyValue(void)
+		{
+			Internal::lazy_join(m_task);
+			if (m_state == Internal::LAZY_DONE)
+			{
+				reinterpret_cast<T*>(&m_storage)->~T();
+			}
+		}
+
+	protected:
+		__forceinline T* getValue()
+		{
+			if (m_state == Internal::LAZY_DONE)
+			{
+				return reinterpret_cast<T*>(&m_storage); /*fast path*/
+			}
+			return initialize();
+		}
+
+		T* initialize()
+		{
+			if (Internal::lazy_begin(m_state))
+			{
+				try
+				{
+					new (&m_storage) T(m_initializer());
+				}
+				catch (...)
+				{
+					Internal::lazy_end(m_state, false);
+					throw;
+				}
+				Internal::lazy_end(m_state, true);
+			}
+			return reinterpret_cast<T*>(&m_storage);
+		}
+
+	private:
+		MUTILS_NO_COPY(LazyValue)
+
+		typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type m_storage;
+		QAtomicInt m_state, m_task;
+		const std::function<T(void)> m_initializer;
+	};
+
+	/**
+	* \brief Group of lazy-initialized values that are warmed up together
+	*
+	* A `LazyGroup` holds references to any number of `Lazy<T>` and `LazyValue<T>` instances, possibly of different types. Calling `prefetch()` starts the initialization of *all* members in parallel, on the global QThreadPool; calling `wait()` blocks until all of them have been initialized. This is intended to overlap expensive detections with other work, e.g. the construction of the GUI, at application startup.
+	*
+	* The `LazyGroup` does **not** take ownership of its members; they must remain valid as long as the `LazyGroup` is used.
+	*/
+	class LazyGroup
+	{
+	public:
+		LazyGroup(void) { }
+
+		/**
+		* \brief Add a member to the group
+		*
+		* \param lazy A reference to the `Lazy<T>` or `LazyValue<T>` instance to be added.
+		*
+		* \return The function returns a reference to this `LazyGroup`, so that calls can be chained.
+		*/
+		template<class L> LazyGroup &add(L &lazy)
+		{
+			m_prefetch.push_back([&lazy]() { lazy.prefetch(); });
+			m_wait.push_back([&lazy]() { *lazy; });
+			return *this;
+		}
+
+		/**
+		* \brief Start the initialization of all members on background threads
+		*/
+		void prefetch(void)
+		{
+			for (std::vector<std::function<void(void)>>::const_iterator iter = m_prefetch.begin(); iter != m_prefetch.end(); ++iter)
+			{
+				(*iter)();
+			}
+		}
+
+		/**
+		* \brief Wait until all members have been initialized
+		*
+		* Members whose initialization has failed are retried on the calling thread.
+		*
+		* \return The function returns `true`, if *all* members have been initialized successfully; otherwise it returns `false`.
+		*/
+		bool wait(void)
+		{
+			bool success = true;
+			for (std::vector<std::function<void(void)>>::const_iterator iter = m_wait.begin(); iter != m_wait.end(); ++iter)
+			{
+				try
+				{
+					(*iter)();
+				}
+				catch (...)
+				{
+					success = false;
+				}
+			}
+			return success;
+		}
+
+	private:
+		MUTILS_NO_COPY(LazyGroup)
+
+		std::vector<std::function<void(void)>> m_prefetch, m_wait;
+	};
+
+	/**
+	* \brief Cached value template class with time-to-live
+	*
+	* The current value of type T can be obtained from a `Cached<T>` instance by using the `operator*()` or the `get()` function. The value is computed by invoking the `initializer` lambda-function that was passed to the constructor. The *first* access blocks until the initial value is available, just like with `Lazy<T>`. After that, the cached value is returned *without* blocking. If the cached value is older than the specified time-to-live, or if it has been invalidated explicitly, the stale value is still returned, but a refresh is started on a thread of the global QThreadPool (*"stale-while-revalidate"*). At most one refresh is running at a time.
+	*
+	* **Note on thread-saftey:** Each value is stored in an immutable, reference-counted snapshot, which is replaced atomically by a refresh. Reading the current snapshot does **not** take any locks: a reader enters the current *epoch*, takes a reference to the snapshot and leaves the epoch again, before the value is copied. A refresh waits until all readers have left the previous epoch, so a replaced snapshot is freed as soon as the last reader has released it and at most one replaced snapshot is pending at any time. Since the value is returned *by value*, type T should be cheap to copy (e.g. implicitly shared Qt types).
+	*/
+	template<typename T> class Cached
+	{
+	public:
+		Cached(std::function<T(void)> &&initializer, const quint32 ttl) : m_ttl(ttl), m_initializer(initializer)
+		{
+			m_clock.start();
+		}
+
+		T operator*(void)
+		{
+			return get();
+		}
+
+		/**
+		* \brief Get the cached value
+		*
+		* \return The function returns a copy of the current value. The value may be stale, if a refresh is still pending.
+		*/
+		T get(void)
+		{
+			if (m_state != Internal::LAZY_DONE)
+			{
+				initialize();
+			}
+			bool stale = false;
+			const T value(read(stale));
+			if (stale)
+			{
+				revalidate();
+			}
+			return value;
+		}
+
+		/**
+		* \brief Refresh the cached value synchronously
+		*
+		* This function invokes the `initializer` lambda-function on the calling thread and replaces the cached value with the result.
+		*
+		* \return The function returns a copy of the new value.
+		*/
+		T refresh(void)
+		{
+			if (m_state != Internal::LAZY_DONE)
+			{
+				initialize();
+				return get();
+			}
+			m_invalid.fetchAndStoreOrdered(0);
+			const T value(m_initializer());
+			publish(value);
+			return value;
+		}
+
+		/**
+		* \brief Invalidate the cached value
+		*
+		* The next access returns the (stale) cached value *and* starts a refresh.
+		*/
+		void invalidate(void)
+		{
+			m_invalid.fetchAndStoreOrdered(1);
+		}
+
+		bool initialized()
+		{
+			return (m_state == Internal::LAZY_DONE);
+		}
+
+		~Cached(void)
+		{
+			Internal::lazy_join(m_task);
+			if (snapshot_t *const snapshot = m_current.fetchAndStoreOrdered(NULL))
+			{
+				release(snapshot);
+			}
+		}
+
+	protected:
+		typedef struct snapshot_t
+		{
+			snapshot_t(const T &_value, const qint64 _timestamp) : value(_value), timestamp(_timestamp), refs(1) { }
+			const T value;
+			const qint64 timestamp;
+			QAtomicInt refs;
+		}
+		snapshot_t;
+
+		void initialize()
+		{
+			if (Internal::lazy_begin(m_state))
+			{
+				try
+				{
+					publish(m_initializer());
+				}
+				catch (...)
+				{
+					Internal::lazy_end(m_state, false);
+					throw;
+				}
+				Internal::lazy_end(m_state, true);
+			}
+		}
+
+		T read(bool &stale)
+		{
+			snapshot_t *const snapshot = acquire();
+			try
+			{
+				const T value(snapshot->value);
+				stale = (m_invalid != 0) || ((m_clock.elapsed() - snapshot->timestamp) >= qint64(m_ttl));
+				release(snapshot);
+				return value;
+			}
+			catch (...)
+			{
+				release(snapshot);
+				throw;
+			}
+		}
+
+		/*
+		 * The epoch guard only protects the short window between loading the pointer and incrementing the reference count
+		 */
+		snapshot_t *acquire(void)
+		{
+			forever
+			{
+				const int epoch = m_epoch;
+				m_guards[epoch].ref();
+				if (m_epoch == epoch)
+				{
+					snapshot_t *const snapshot = m_current;
+					snapshot->refs.ref();
+					m_guards[epoch].deref();
+					return snapshot;
+				}
+				m_guards[epoch].deref(); /*epoch has changed, try again*/
+			}
+		}
+
+		static void release(snapshot_t *const snapshot)
+		{
+			if (!snapshot->refs.deref())
+			{
+				delete snapshot;
+			}
+		}
+
+		void publish(const T &value)
+		{
+			snapshot_t *const snapshot = new snapshot_t(value, m_clock.elapsed());
+			QMutexLocker lock(&m_publishLock); /*serializes the writers only*/
+			snapshot_t *const previous = m_current.fetchAndStoreOrdered(snapshot);
+			if (previous)
+			{
+				const int epoch = m_epoch.fetchAndStoreOrdered(m_epoch ^ 1);
+				while (m_guards[epoch] != 0)
+				{
+					QThread::yieldCurrentThread(); /*wait until no reader can take a new reference*/
+				}
+				release(previous);
+			}
+		}
+
+		void revalidate()
+		{
+			m_task.testAndSetOrdered(Internal::LAZY_TASK_DONE, Internal::LAZY_TASK_NONE);
+			Internal::lazy_prefetch(m_task, [this]()
+			{
+				m_invalid.fetchAndStoreOrdered(0);
+				try
+				{
+					this->publish(m_initializer());
+				}
+				catch (...)
+				{
+					m_invalid.fetchAndStoreOrdered(1);
+				}
+			});
+		}
+
+	private:
+		MUTILS_NO_COPY(Cached)
+
+		QAtomicPointer<snapshot_t> m_current;
+		QAtomicInt m_state, m_task, m_invalid, m_epoch;
+		QAtomicInt m_guards[2];
+		QMutex m_publishLock;
+		QElapsedTimer m_clock;
+		const quint32 m_ttl;
+		const std::function<T(void)> m_initializer;
+	};
 }
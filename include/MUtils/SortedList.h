@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains the NaturalSortedList class for keeping strings in "natural" order
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QString>
+#include <QStringList>
+
+namespace MUtils
+{
+	class MUTILS_API NaturalSortedList_Private;
+
+	/**
+	* \brief This class implements a list of strings that is kept in "natural" order
+	*
+	* The strings are ordered exactly like natural_string_sort() would order them, but the order is maintained *incrementally*: Inserting or removing a string does **not** require the list to be re-sorted. The sort key of each string is computed only once, when the string is inserted (see natural_sort_key()).
+	*
+	* Internally, the strings are stored in sorted chunks of bounded size, similar to the leaves of a B-tree, and the chunk sizes are indexed by a Fenwick tree. Hence, insertions, removals, look-ups and rank queries take O(log n) time. The list may contain duplicates.
+	*
+	* This class is **not** thread-safe. Indices are zero-based; an index must be in the `[0, count())` range, unless stated otherwise.
+	*/
+	class MUTILS_API NaturalSortedList
+	{
+	public:
+		/**
+		* \brief Create a new, empty NaturalSortedList instance
+		*
+		* \param bIgnoreCase If set to `true`, the strings will be ordered disregarding the character case; if set to `false`, the character case *is* taken into account.
+		*/
+		NaturalSortedList(const bool bIgnoreCase = false);
+
+		/**
+		* \brief Destroys the NaturalSortedList instance
+		*/
+		~NaturalSortedList(void);
+
+		/**
+		* \brief Insert a string
+		*
+		* \param str A read-only reference to the QString object to be inserted. If the list already contains equal strings, the new string is inserted *after* them.
+		*
+		* \return The function returns the index at which the string has been inserted.
+		*/
+		int insert(const QString &str);
+
+		/**
+		* \brief Insert a list of strings
+		*
+		* If the given list is large, compared to the current size, the list is rebuilt in a single pass, which is faster than inserting each string individually.
+		*
+		* \param list A read-only reference to the QStringList object containing the strings to be inserted. The given list does *not* need to be sorted.
+		*/
+		void insert(const QStringList &list);
+
+		/**
+		* \brief Remove a string
+		*
+		* \param str A read-only reference to the QString object to be removed. If the list contains several equal strings, only one of them is removed.
+		*
+		* \return The function returns `true`, if the string was found and removed; otherwise it returns `false`.
+		*/
+		bool remove(const QString &str);
+
+		/**
+		* \brief Remove the string at the specified index
+		*/
+		void removeAt(const int index);
+
+		/**
+		* \brief Remove all strings
+		*/
+		void clear(void);
+
+		/**
+		* \brief Returns the number of strings in the list
+		*/
+		int count(void) const;
+
+		/**
+		* \brief Returns `true`, if the list is empty; otherwise returns `false`
+		*/
+		bool isEmpty(void) const { return (count() < 1); }
+
+		/**
+		* \brief Returns the string at the specified index
+		*/
+		const QString &at(const int index) const;
+
+		/**
+		* \brief Returns the string at the specified index
+		*/
+		const QString &operator[](const int index) const { return at(index); }
+
+		/**
+		* \brief Find a string
+		*
+		* \return The function returns the index of the *first* string that is equal to the given string, or `-1` if the list does not contain the given string.
+		*/
+		int indexOf(const QString &str) const;
+
+		/**
+		* \brief Returns `true`, if the list contains the given string; otherwise returns `false`
+		*/
+		bool contains(const QString &str) const { return (indexOf(str) >= 0); }
+
+		/**
+		* \brief Rank query
+		*
+		* \return The function returns the number of strings in the list that sort *before* the given string. The given string does *not* need to be contained in the list.
+		*/
+		int lowerBound(const QString &str) const;
+
+		/**
+		* \brief Rank query
+		*
+		* \return The function returns the number of strings in the list that sort *before* or are equal to the given string. The given string does *not* need to be contained in the list.
+		*/
+		int upperBound(const QString &str) const;
+
+		/**
+		* \brief Range query, by index
+		*
+		* \param first The index of the first string to be returned. Must be in the `[0, count()]` range.
+		*
+		* \param last The index *after* the last string to be returned. Must be in the `[first, count()]` range.
+		*
+		* \return The function returns a QStringList containing the strings in the `[first, last)` range, in "natural" order.
+		*/
+		QStringList range(const int first, const int last) const;
+
+		/**
+		* \brief Range query, by value
+		*
+		* \return The function returns a QStringList containing all strings that sort *not before* the `lower` string and *before* the `upper` string, in "natural" order.
+		*/
+		QStringList range(const QString &lower, const QString &upper) const;
+
+		/**
+		* \brief Returns a QStringList containing all strings, in "natural" order
+		*/
+		QStringList toList(void) const { return range(0, count()); }
+
+	private:
+		NaturalSortedList(const NaturalSortedList&) : p(NULL) { throw "Constructor is disabled!"; }
+		NaturalSortedList &operator=(const NaturalSortedList&) { throw "Assignment operator is disabled!"; }
+
+		NaturalSortedList_Private *const p;
+	};
+}
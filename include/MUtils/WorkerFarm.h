@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/**
+* @file
+* @brief This file contains the WorkerFarm class for distributing jobs to a pool of worker processes
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QByteArray>
+#include <QStringList>
+
+namespace MUtils
+{
+	class MUTILS_API WorkerFarm_Private;
+
+	/**
+	* \brief This class implements a pool of worker processes ("farm")
+	*
+	* The *master* process starts a fixed number of worker processes, which run the *same* executable in "worker" mode. Jobs are handed out to the workers through a queue in shared memory and the results are passed back the same way, so a worker process is started only once rather than once per job. This allows for using all CPU cores with code that is *not* thread-safe.
+	*
+	* If a worker process terminates unexpectedly, it is restarted automatically and the job that it was processing is handed out again, up to MAX_RETRIES times. In rare cases, this means that a job is processed more than once; only the first result is returned.
+	*
+	* The application must call isWorker() early in its `main()` function and, if that function returns `true`, call runWorker() and exit with the returned exit code.
+	*/
+	class MUTILS_API WorkerFarm
+	{
+	public:
+		static const quint32 MAX_RETRIES = 2U;					///< \brief Maximum number of times that a job is handed out again after its worker has crashed
+		static const quint32 INFINITE_TIMEOUT = 0xFFFFFFFF;		///< \brief Wait without a timeout
+
+		/**
+		* \brief Job processing function
+		*
+		* This function is called in the worker process for each job.
+		*
+		* \param input A read-only reference to a QByteArray object holding the input data of the job.
+		*
+		* \param output A reference to a QByteArray object that receives the output data of the job.
+		*
+		* \param userData The user-defined pointer that was passed to runWorker().
+		*
+		* \return The function shall return `true`, if the job was completed successfully; otherwise it shall return `false`.
+		*/
+		typedef bool (*job_function_t)(const QByteArray &input, QByteArray &output, void *const userData);
+
+		/**
+		* \brief The result of a job
+		*/
+		typedef struct
+		{
+			quint32 jobId;			///< \brief The job identifier, as returned by submit()
+			bool success;			///< \brief `true`, if the job was completed successfully; `false`, if it has failed or if its worker has crashed too often
+			QByteArray output;		///< \brief The output data of the job
+		}
+		farm_result_t;
+
+		/**
+		* \brief Create a new WorkerFarm instance
+		*
+		* \param applicationId The application identifier. The *same* identifier must be passed to runWorker().
+		*
+		* \param appVersionNo The application version number. The *same* number must be passed to runWorker().
+		*
+		* \param workerCount The number of worker processes. If this is zero, the number of CPU cores is used.
+		*
+		* \param arguments Additional command-line arguments to be passed to the worker processes.
+		*/
+		WorkerFarm(const QString &applicationId, const quint32 &appVersionNo, const quint32 &workerCount = 0, const QStringList &arguments = QStringList());
+
+		/**
+		* \brief Destroys the WorkerFarm instance
+		*
+		* All worker processes are stopped, jobs that have not been completed yet are discarded.
+		*/
+		~WorkerFarm(void);
+
+		/**
+		* \brief Start the worker processes
+		*
+		* \return The function returns `true`, if the job queue was created and all worker processes were started successfully; otherwise it returns `false`.
+		*/
+		bool start(void);
+
+		/**
+		* \brief Stop the worker processes
+		*
+		* The workers are asked to exit and are terminated, if they do not exit in time. Jobs that have not been completed yet are discarded.
+		*/
+		void stop(void);
+
+		/**
+		* \brief Submit a job
+		*
+		* The job is appended to the queue; this function blocks only while the queue is full. In the meantime, the results of completed jobs are received, so that they can be collected later.
+		*
+		* \param input A read-only reference to a QByteArray object holding the input data of the job.
+		*
+		* \return The function returns the job identifier (greater than zero), if the job was submitted successfully; otherwise (e.g. if the input data exceeds the maximum message size of the job queue) it returns zero.
+		*/
+		quint32 submit(const QByteArray &input);
+
+		/**
+		* \brief Collect the result of the next completed job
+		*
+		* Results are returned in the order in which the jobs were *completed*, which is not necessarily the order in which they were submitted. Crashed workers are restarted while waiting.
+		*
+		* \param result A reference to a farm_result_t object that receives the result.
+		*
+		* \param timeout The maximum time to wait, in milliseconds.
+		*
+		* \return The function returns `true`, if a result was collected; otherwise (timeout, no pending jobs or error) it returns `false`.
+		*/
+		bool collect(farm_result_t &result, const quint32 &timeout = INFINITE_TIMEOUT);
+
+		/**
+		* \brief Get the number of jobs that have been submitted, but not collected yet
+		*/
+		quint32 pending(void) const;
+
+		/**
+		* \brief Test whether *this* process was started as a worker process
+		*/
+		static bool isWorker(void);
+
+		/**
+		* \brief Run the worker loop
+		*
+		* This function processes jobs until the master stops the farm or terminates. It must be called only if isWorker() has returned `true`.
+		*
+		* \param applicationId The application identifier, as passed to the WorkerFarm constructor in the master process.
+		*
+		* \param appVersionNo The application version number, as passed to the WorkerFarm constructor in the master process.
+		*
+		* \param function The function that processes the jobs.
+		*
+		* \param userData A user-defined pointer that is passed to the job processing function.
+		*
+		* \return The function returns the exit code for the worker process.
+		*/
+		static int runWorker(const QString &applicationId, const quint32 &appVersionNo, const job_function_t function, void *const userData = NULL);
+
+	private:
+		MUTILS_NO_COPY(WorkerFarm)
+
+		WorkerFarm_Private *const p;
+	};
+}
@@ -43,10 +43,50 @@ namespace MUtils
 	namespace Internal
 	{
 		uint32_t adler32(uint32_t adler, const unsigned char *buf, uint32_t len);
+		uint32_t adler32_combine(uint32_t adler1, uint32_t adler2, uint64_t len2);
+
+		/* explicit kernel selection, used for testing the SIMD paths against the scalar path */
+		typedef enum
+		{
+			ADLER32_SCALAR = 0,
+			ADLER32_SSSE3  = 1,
+			ADLER32_AVX2   = 2
+		}
+		adler32_kernel_t;
+
+		bool adler32_supported(const adler32_kernel_t kernel);
+		uint32_t adler32_kernel(const adler32_kernel_t kernel, uint32_t adler, const unsigned char *buf, uint32_t len);
 
 		inline uint32_t adler32(const uint32_t &adler, const void *const buf, const uint32_t &len)
 		{
 			return adler32(adler, reinterpret_cast<const unsigned char*>(buf), len);
 		}
+
+		class adler32_rolling
+		{
+		public:
+			adler32_rolling(const uint32_t window) : m_window(window), m_window_mod(window % BASE), m_s1(1U), m_s2(0U) {}
+
+			inline void init(const unsigned char *const buf)
+			{
+				const uint32_t value = adler32(1U, buf, m_window);
+				m_s1 = value & 0xFFFF;
+				m_s2 = (value >> 16) & 0xFFFF;
+			}
+
+			inline void roll(const unsigned char out, const unsigned char in)
+			{
+				m_s1 = (m_s1 + in + BASE - out) % BASE;
+				m_s2 = (m_s2 + (BASE - ((m_window_mod * out) % BASE)) + m_s1 + (BASE - 1U)) % BASE;
+			}
+
+			inline uint32_t value(void) const { return m_s1 | (m_s2 << 16); }
+			inline uint32_t window(void) const { return m_window; }
+
+		private:
+			static const uint32_t BASE = 65521U;
+			const uint32_t m_window, m_window_mod;
+			uint32_t m_s1, m_s2;
+		};
 	}
 }
@@ -35,6 +35,23 @@
 
 #include "../include/adler32.h"
 
+//MUtils
+#include <MUtils/CPUFeatures.h>
+
+//SIMD
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define ADLER32_SIMD 1
+#include <immintrin.h>
+#else
+#define ADLER32_SIMD 0
+#endif
+
+#if defined(__GNUC__)
+#define TARGET(X) __attribute__((target(X)))
+#else
+#define TARGET(X)
+#endif
+
 #define local     static
 #define uLong     uint32_t
 #define uInt      uint32_t
@@ -67,7 +84,7 @@
 #define MOD63(a) a %= BASE
 
 /* ========================================================================= */
-uLong ZEXPORT MUtils::Internal::adler32(uLong adler, const Bytef *buf, uInt len)
+local uLong adler32_c(uLong adler, const Bytef *buf, uInt len)
 {
 	unsigned long sum2;
 	unsigned n;
@@ -133,3 +150,219 @@ uLong ZEXPORT MUtils::Internal::adler32(uLong adler, const Bytef *buf, uInt len)
 	/* return recombined sums */
 	return adler | (sum2 << 16);
 }
+
+/* ========================================================================= */
+#if ADLER32_SIMD
+
+/*
+ * The SIMD kernels are based on the approach by Noel Gordon (Chromium zlib):
+ * process blocks of bytes in parallel, where "sum2" is computed as the dot
+ * product of the input bytes and a descending tap vector, plus the block size
+ * times the "sum1" value at the start of each block.
+ */
+
+local uLong adler32_tail(uLong adler, uLong sum2, const Bytef *buf, uInt len)
+{
+	while (len--) {
+		adler += *buf++;
+		sum2 += adler;
+	}
+	MOD(adler);
+	MOD(sum2);
+	return adler | (sum2 << 16);
+}
+
+TARGET("ssse3")
+local uLong adler32_ssse3(uLong adler, const Bytef *buf, uInt len)
+{
+	static const uInt BLOCK_SIZE = 1 << 5;
+	uInt s1 = adler & 0xffff;
+	uInt s2 = (adler >> 16) & 0xffff;
+	uInt blocks = len / BLOCK_SIZE;
+	len -= blocks * BLOCK_SIZE;
+
+	while (blocks) {
+		uInt n = NMAX / BLOCK_SIZE; /* NMAX constraint */
+		if (n > blocks)
+			n = blocks;
+		blocks -= n;
+
+		const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+
+		__m128i v_ps = _mm_set_epi32(0, 0, 0, s1 * n);
+		__m128i v_s2 = _mm_set_epi32(0, 0, 0, s2);
+		__m128i v_s1 = _mm_setzero_si128();
+
+		do {
+			const __m128i bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+			const __m128i bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 16));
+			v_ps = _mm_add_epi32(v_ps, v_s1);
+			v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+			v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+			v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+			v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+			buf += BLOCK_SIZE;
+		} while (--n);
+
+		v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+		/* horizontal sums */
+		v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+		v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+		s1 += static_cast<uInt>(_mm_cvtsi128_si32(v_s1));
+		v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+		v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+		s2 = static_cast<uInt>(_mm_cvtsi128_si32(v_s2));
+
+		MOD(s1);
+		MOD(s2);
+	}
+
+	return adler32_tail(s1, s2, buf, len);
+}
+
+TARGET("avx2")
+local uLong adler32_avx2(uLong adler, const Bytef *buf, uInt len)
+{
+	static const uInt BLOCK_SIZE = 1 << 6;
+	uInt s1 = adler & 0xffff;
+	uInt s2 = (adler >> 16) & 0xffff;
+	uInt blocks = len / BLOCK_SIZE;
+	len -= blocks * BLOCK_SIZE;
+
+	while (blocks) {
+		uInt n = NMAX / BLOCK_SIZE; /* NMAX constraint */
+		if (n > blocks)
+			n = blocks;
+		blocks -= n;
+
+		const __m256i tap1 = _mm256_setr_epi8(64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33);
+		const __m256i tap2 = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10,  9,  8,  7,  6,  5,  4,  3,  2,  1);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i ones = _mm256_set1_epi16(1);
+
+		__m256i v_ps = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s1 * n);
+		__m256i v_s2 = _mm256_set_epi32(0, 0, 0, 0, 0, 0, 0, s2);
+		__m256i v_s1 = _mm256_setzero_si256();
+
+		do {
+			const __m256i bytes1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf));
+			const __m256i bytes2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf + 32));
+			v_ps = _mm256_add_epi32(v_ps, v_s1);
+			v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes1, zero));
+			v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes1, tap1), ones));
+			v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes2, zero));
+			v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes2, tap2), ones));
+			buf += BLOCK_SIZE;
+		} while (--n);
+
+		v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 6));
+
+		/* horizontal sums */
+		__m128i h_s1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+		__m128i h_s2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+		h_s1 = _mm_add_epi32(h_s1, _mm_shuffle_epi32(h_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+		h_s1 = _mm_add_epi32(h_s1, _mm_shuffle_epi32(h_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+		s1 += static_cast<uInt>(_mm_cvtsi128_si32(h_s1));
+		h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+		h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+		s2 = static_cast<uInt>(_mm_cvtsi128_si32(h_s2));
+
+		MOD(s1);
+		MOD(s2);
+	}
+
+	_mm256_zeroupper();
+	return adler32_tail(s1, s2, buf, len);
+}
+
+#endif //ADLER32_SIMD
+
+/* ========================================================================= */
+typedef uLong (*adler32_func_t)(uLong adler, const Bytef *buf, uInt len);
+
+local adler32_func_t adler32_select(void)
+{
+#if ADLER32_SIMD
+	const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+	if (cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+		return adler32_avx2;
+	if (cpuInfo.features & MUtils::CPUFetaures::FLAG_SSSE3)
+		return adler32_ssse3;
+#endif //ADLER32_SIMD
+	return adler32_c;
+}
+
+uLong ZEXPORT MUtils::Internal::adler32(uLong adler, const Bytef *buf, uInt len)
+{
+	/* short inputs are not worth the SIMD setup cost */
+	if ((len < 64) || (buf == Z_NULL))
+		return adler32_c(adler, buf, len);
+
+	static const adler32_func_t adler32_impl = adler32_select();
+	return adler32_impl(adler, buf, len);
+}
+
+/* ========================================================================= */
+bool MUtils::Internal::adler32_supported(const adler32_kernel_t kernel)
+{
+#if ADLER32_SIMD
+	const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+	switch (kernel)
+	{
+	case ADLER32_AVX2:
+		return (cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2) != 0;
+	case ADLER32_SSSE3:
+		return (cpuInfo.features & MUtils::CPUFetaures::FLAG_SSSE3) != 0;
+	default:
+		break;
+	}
+#endif //ADLER32_SIMD
+	return (kernel == ADLER32_SCALAR);
+}
+
+uLong ZEXPORT MUtils::Internal::adler32_kernel(const adler32_kernel_t kernel, uLong adler, const Bytef *buf, uInt len)
+{
+	/* the caller must check adler32_supported() first */
+#if ADLER32_SIMD
+	switch (kernel)
+	{
+	case ADLER32_AVX2:
+		return adler32_avx2(adler, buf, len);
+	case ADLER32_SSSE3:
+		return adler32_ssse3(adler, buf, len);
+	default:
+		break;
+	}
+#endif //ADLER32_SIMD
+	return adler32_c(adler, buf, len);
+}
+
+/* ========================================================================= */
+/*
+ * Combine the checksums of two adjacent chunks, where "adler2" must have been
+ * computed with the initial value of 1 and "len2" is the length of the second
+ * chunk. This allows for checksumming large buffers in parallel.
+ */
+uLong ZEXPORT MUtils::Internal::adler32_combine(uLong adler1, uLong adler2, uint64_t len2)
+{
+	unsigned long sum1;
+	unsigned long sum2;
+	unsigned rem;
+
+	/* the derivation of this formula is left as an exercise for the reader */
+	rem = (unsigned)(len2 % BASE);
+	sum1 = adler1 & 0xffff;
+	sum2 = rem * sum1;
+	MOD(sum2);
+	sum1 += (adler2 & 0xffff) + BASE - 1;
+	sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+	if (sum1 >= BASE) sum1 -= BASE;
+	if (sum1 >= BASE) sum1 -= BASE;
+	if (sum2 >= ((unsigned long)BASE << 1)) sum2 -= ((unsigned long)BASE << 1);
+	if (sum2 >= BASE) sum2 -= BASE;
+	return sum1 | (sum2 << 16);
+}
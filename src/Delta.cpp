@@ -0,0 +1,551 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Delta.h>
+#include <MUtils/Hash.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "3rd_party/adler32/include/adler32.h"
+
+//Qt
+#include <QIODevice>
+#include <QBuffer>
+#include <QDataStream>
+#include <QHash>
+#include <QVector>
+#include <QScopedPointer>
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTANTS
+///////////////////////////////////////////////////////////////////////////////
+
+static const quint32 SIGNATURE_MAGIC = 0x4D554453; //"MUDS"
+static const quint32 DELTA_MAGIC     = 0x4D554444; //"MUDD"
+static const quint16 FORMAT_VERSION  = 1U;
+
+static const quint32 MAX_BLOCK_SIZE  = 16777216U;
+static const qint64  READ_CHUNK_SIZE = Q_INT64_C(4194304);
+static const int     MAX_LITERAL_LEN = 1048576;
+
+typedef enum
+{
+	OP_END  = 0x00,
+	OP_COPY = 0x01,
+	OP_DATA = 0x02
+}
+delta_op_t;
+
+///////////////////////////////////////////////////////////////////////////////
+// UTILITIES
+///////////////////////////////////////////////////////////////////////////////
+
+static void init_stream(QDataStream &stream)
+{
+	stream.setVersion(QDataStream::Qt_4_8);
+	stream.setByteOrder(QDataStream::LittleEndian);
+}
+
+static bool read_fully(QIODevice &device, const qint64 len, QByteArray &data)
+{
+	data.clear();
+	while (qint64(data.size()) < len)
+	{
+		const QByteArray chunk = device.read(len - qint64(data.size()));
+		if (chunk.isEmpty())
+		{
+			break; /*EOF or error*/
+		}
+		data.append(chunk);
+	}
+	return (qint64(data.size()) == len);
+}
+
+/*
+ * The hash id may come from an untrusted signature or delta, so an unknown id must result in an error, rather than an exception
+ */
+static MUtils::Hash::Hash *create_hash(const quint16 hashId)
+{
+	try
+	{
+		return MUtils::Hash::create(hashId);
+	}
+	catch (const std::exception&)
+	{
+		qWarning("Delta uses an unsupported hash algorithm: 0x%04X", quint32(hashId));
+		return NULL;
+	}
+}
+
+static QByteArray strong_hash(MUtils::Hash::Hash &hash, const char *const data, const quint32 len)
+{
+	hash.reset();
+	hash.update(reinterpret_cast<const quint8*>(data), len);
+	return hash.digest(false).left(MUtils::Delta::STRONG_HASH_LEN);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SIGNATURE
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	quint16 hashId;
+	quint32 blockSize;
+	quint64 fileSize;
+	QVector<quint32> weak;
+	QByteArray strong;
+}
+signature_t;
+
+static bool parse_signature(const QByteArray &data, signature_t &sig)
+{
+	QDataStream stream(data);
+	init_stream(stream);
+
+	quint32 magic, blockCount;
+	quint16 version;
+	stream >> magic >> version >> sig.hashId >> sig.blockSize >> sig.fileSize >> blockCount;
+
+	if ((stream.status() != QDataStream::Ok) || (magic != SIGNATURE_MAGIC) || (version != FORMAT_VERSION))
+	{
+		qWarning("Delta signature is invalid or has an unsupported version!");
+		return false;
+	}
+
+	if ((sig.blockSize < 1U) || (sig.blockSize > MAX_BLOCK_SIZE) || (quint64(blockCount) != ((sig.fileSize + sig.blockSize - 1U) / sig.blockSize)) || (quint64(blockCount) * (sizeof(quint32) + MUtils::Delta::STRONG_HASH_LEN) > quint64(data.size())))
+	{
+		qWarning("Delta signature is corrupted!");
+		return false;
+	}
+
+	sig.weak.resize(blockCount);
+	sig.strong.resize(blockCount * MUtils::Delta::STRONG_HASH_LEN);
+	for (quint32 i = 0; i < blockCount; ++i)
+	{
+		stream >> sig.weak[i];
+		if (stream.readRawData(sig.strong.data() + (i * MUtils::Delta::STRONG_HASH_LEN), MUtils::Delta::STRONG_HASH_LEN) != int(MUtils::Delta::STRONG_HASH_LEN))
+		{
+			qWarning("Delta signature is truncated!");
+			return false;
+		}
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+bool MUtils::Delta::signature(QIODevice &basis, QByteArray &signature, const quint32 blockSize, const quint16 hashId)
+{
+	signature.clear();
+
+	if ((blockSize < 1U) || (blockSize > MAX_BLOCK_SIZE))
+	{
+		qWarning("Invalid delta block size has been specified!");
+		return false;
+	}
+
+	const QScopedPointer<Hash::Hash> hash(create_hash(hashId));
+	if (hash.isNull())
+	{
+		return false;
+	}
+
+	QVector<quint32> weak;
+	QByteArray strong, block;
+	quint64 fileSize = 0;
+
+	forever
+	{
+		const bool fullBlock = read_fully(basis, blockSize, block);
+		if (block.isEmpty())
+		{
+			break; /*no more data*/
+		}
+		weak.append(Internal::adler32(1U, block.constData(), quint32(block.size())));
+		strong.append(strong_hash(*hash, block.constData(), quint32(block.size())));
+		fileSize += quint64(block.size());
+		if (!fullBlock)
+		{
+			break; /*short block is always the last one*/
+		}
+	}
+
+	QBuffer buffer(&signature);
+	if (!buffer.open(QIODevice::WriteOnly))
+	{
+		qWarning("Failed to open signature buffer!");
+		return false;
+	}
+
+	QDataStream stream(&buffer);
+	init_stream(stream);
+	stream << SIGNATURE_MAGIC << FORMAT_VERSION << hashId << blockSize << fileSize << quint32(weak.count());
+	for (int i = 0; i < weak.count(); ++i)
+	{
+		stream << weak[i];
+		stream.writeRawData(strong.constData() + (i * STRONG_HASH_LEN), STRONG_HASH_LEN);
+	}
+
+	return (stream.status() == QDataStream::Ok);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// GENERATE DELTA
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Delta
+	{
+		class DeltaWriter
+		{
+		public:
+			DeltaWriter(QIODevice &device) : m_stream(&device), m_first(0U), m_count(0U)
+			{
+				init_stream(m_stream);
+			}
+
+			void header(const quint16 hashId, const quint32 blockSize)
+			{
+				m_stream << DELTA_MAGIC << FORMAT_VERSION << hashId << blockSize;
+			}
+
+			void copy(const quint32 index)
+			{
+				if (m_count && (m_first + m_count == index))
+				{
+					m_count++;
+					return;
+				}
+				flush();
+				m_first = index;
+				m_count = 1U;
+			}
+
+			void literal(const char *const data, const int len)
+			{
+				if (len > 0)
+				{
+					flush();
+					m_stream << quint8(OP_DATA) << quint32(len);
+					m_stream.writeRawData(data, len);
+				}
+			}
+
+			bool finish(const quint64 targetSize, const QByteArray &digest)
+			{
+				flush();
+				m_stream << quint8(OP_END) << targetSize << digest;
+				return (m_stream.status() == QDataStream::Ok);
+			}
+
+		private:
+			void flush(void)
+			{
+				if (m_count)
+				{
+					m_stream << quint8(OP_COPY) << m_first << m_count;
+					m_count = 0U;
+				}
+			}
+
+			QDataStream m_stream;
+			quint32 m_first, m_count;
+		};
+	}
+}
+
+static qint32 find_block(const signature_t &sig, const QHash<quint32, qint32> &index, const QVector<qint32> &chain, MUtils::Hash::Hash &hash, const quint32 weak, const char *const data)
+{
+	QHash<quint32, qint32>::ConstIterator iter = index.constFind(weak);
+	if (iter == index.constEnd())
+	{
+		return -1;
+	}
+
+	const QByteArray strong = strong_hash(hash, data, sig.blockSize);
+	for (qint32 i = iter.value(); i >= 0; i = chain[i])
+	{
+		if (memcmp(strong.constData(), sig.strong.constData() + (i * MUtils::Delta::STRONG_HASH_LEN), MUtils::Delta::STRONG_HASH_LEN) == 0)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+bool MUtils::Delta::generate(const QByteArray &signature, QIODevice &target, QIODevice &delta)
+{
+	signature_t sig;
+	if (!parse_signature(signature, sig))
+	{
+		return false;
+	}
+
+	//Index all *full* blocks by weak checksum
+	const quint32 tailLen = quint32(sig.fileSize % sig.blockSize);
+	const qint32 fullBlocks = sig.weak.count() - (tailLen ? 1 : 0);
+	QHash<quint32, qint32> index;
+	QVector<qint32> chain(fullBlocks, -1);
+	for (qint32 i = fullBlocks - 1; i >= 0; --i)
+	{
+		QHash<quint32, qint32>::Iterator iter = index.find(sig.weak[i]);
+		if (iter != index.end())
+		{
+			chain[i] = iter.value();
+			iter.value() = i;
+		}
+		else
+		{
+			index.insert(sig.weak[i], i);
+		}
+	}
+
+	const QScopedPointer<Hash::Hash> digest(create_hash(sig.hashId)), hash(create_hash(sig.hashId));
+	if (digest.isNull() || hash.isNull())
+	{
+		return false;
+	}
+
+	DeltaWriter writer(delta);
+	writer.header(sig.hashId, sig.blockSize);
+
+	Internal::adler32_rolling weak(sig.blockSize);
+	const int blockSize = int(sig.blockSize);
+
+	QByteArray buffer;
+	quint64 targetSize = 0;
+	int pos = 0, litStart = 0;
+	bool windowValid = false, eof = false;
+
+	forever
+	{
+		//Refill the buffer, keeping the pending literal data
+		if ((!eof) && (buffer.size() - pos <= blockSize))
+		{
+			if (litStart > 0)
+			{
+				buffer.remove(0, litStart);
+				pos -= litStart;
+				litStart = 0;
+			}
+			const QByteArray chunk = target.read(READ_CHUNK_SIZE);
+			if (chunk.isEmpty())
+			{
+				eof = true;
+			}
+			else
+			{
+				digest->update(chunk);
+				targetSize += quint64(chunk.size());
+				buffer.append(chunk);
+			}
+			continue;
+		}
+
+		if (buffer.size() - pos < blockSize)
+		{
+			break; /*less than one block remaining*/
+		}
+
+		const char *const ptr = buffer.constData() + pos;
+		if (!windowValid)
+		{
+			weak.init(reinterpret_cast<const unsigned char*>(ptr));
+			windowValid = true;
+		}
+
+		const qint32 match = find_block(sig, index, chain, *hash, weak.value(), ptr);
+		if (match >= 0)
+		{
+			writer.literal(buffer.constData() + litStart, pos - litStart);
+			writer.copy(quint32(match));
+			pos += blockSize;
+			litStart = pos;
+			windowValid = false;
+			continue;
+		}
+
+		if (buffer.size() - pos > blockSize)
+		{
+			weak.roll(quint8(ptr[0]), quint8(ptr[blockSize]));
+		}
+		else
+		{
+			windowValid = false;
+		}
+
+		if (++pos - litStart >= MAX_LITERAL_LEN)
+		{
+			writer.literal(buffer.constData() + litStart, pos - litStart);
+			litStart = pos;
+		}
+	}
+
+	//The last block of the basis may be shorter than the block size
+	if (tailLen && (buffer.size() - pos == int(tailLen)))
+	{
+		const char *const ptr = buffer.constData() + pos;
+		const qint32 last = sig.weak.count() - 1;
+		if (Internal::adler32(1U, ptr, tailLen) == sig.weak[last])
+		{
+			const QByteArray strong = strong_hash(*hash, ptr, tailLen);
+			if (memcmp(strong.constData(), sig.strong.constData() + (last * STRONG_HASH_LEN), STRONG_HASH_LEN) == 0)
+			{
+				writer.literal(buffer.constData() + litStart, pos - litStart);
+				writer.copy(quint32(last));
+				litStart = pos = buffer.size();
+			}
+		}
+	}
+
+	writer.literal(buffer.constData() + litStart, buffer.size() - litStart);
+	if (!writer.finish(targetSize, digest->digest(false)))
+	{
+		qWarning("Failed to write delta data!");
+		return false;
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// APPLY DELTA
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::Delta::apply(QIODevice &basis, QIODevice &delta, QIODevice &output)
+{
+	QDataStream stream(&delta);
+	init_stream(stream);
+
+	quint32 magic, blockSize;
+	quint16 version, hashId;
+	stream >> magic >> version >> hashId >> blockSize;
+
+	if ((stream.status() != QDataStream::Ok) || (magic != DELTA_MAGIC) || (version != FORMAT_VERSION) || (blockSize < 1U) || (blockSize > MAX_BLOCK_SIZE))
+	{
+		qWarning("Delta is invalid or has an unsupported version!");
+		return false;
+	}
+
+	const QScopedPointer<Hash::Hash> digest(create_hash(hashId));
+	if (digest.isNull())
+	{
+		return false;
+	}
+
+	quint64 outputSize = 0;
+	QByteArray data;
+
+	forever
+	{
+		quint8 op;
+		stream >> op;
+		if (stream.status() != QDataStream::Ok)
+		{
+			qWarning("Delta is truncated!");
+			return false;
+		}
+
+		switch (op)
+		{
+		case OP_COPY:
+			{
+				quint32 first, count;
+				stream >> first >> count;
+				if ((stream.status() != QDataStream::Ok) || (!basis.seek(qint64(first) * qint64(blockSize))))
+				{
+					qWarning("Delta refers to an invalid basis block!");
+					return false;
+				}
+				qint64 remaining = qint64(count) * qint64(blockSize);
+				while (remaining > 0)
+				{
+					const QByteArray chunk = basis.read(qMin(remaining, READ_CHUNK_SIZE));
+					if (chunk.isEmpty())
+					{
+						break; /*last block may be short*/
+					}
+					if (output.write(chunk) != qint64(chunk.size()))
+					{
+						qWarning("Failed to write output data!");
+						return false;
+					}
+					digest->update(chunk);
+					outputSize += quint64(chunk.size());
+					remaining -= qint64(chunk.size());
+				}
+				if ((remaining >= qint64(blockSize)) || ((remaining > 0) && (!basis.atEnd())))
+				{
+					qWarning("Basis is shorter than expected by the delta!");
+					return false;
+				}
+			}
+			break;
+		case OP_DATA:
+			{
+				quint32 len;
+				stream >> len;
+				if ((stream.status() != QDataStream::Ok) || (len > quint32(MAX_LITERAL_LEN)))
+				{
+					qWarning("Delta literal is invalid!");
+					return false;
+				}
+				data.resize(int(len));
+				if (stream.readRawData(data.data(), int(len)) != int(len))
+				{
+					qWarning("Delta is truncated!");
+					return false;
+				}
+				if (output.write(data) != qint64(len))
+				{
+					qWarning("Failed to write output data!");
+					return false;
+				}
+				digest->update(data);
+				outputSize += quint64(len);
+			}
+			break;
+		case OP_END:
+			{
+				quint64 targetSize;
+				QByteArray targetDigest;
+				stream >> targetSize >> targetDigest;
+				if (stream.status() != QDataStream::Ok)
+				{
+					qWarning("Delta is truncated!");
+					return false;
+				}
+				if ((targetSize != outputSize) || (targetDigest != digest->digest(false)))
+				{
+					qWarning("Delta verification has failed, output is corrupted!");
+					return false;
+				}
+			}
+			return true;
+		default:
+			qWarning("Delta contains an unknown operation: 0x%02X", quint32(op));
+			return false;
+		}
+	}
+}
@@ -27,15 +27,17 @@
 #include <MUtils/Global.h>
 #include <MUtils/OSSupport.h>
 #include <MUtils/Version.h>
+#include <MUtils/Lazy.h>
+#include <MUtils/CPUFeatures.h>
 #include "Internal.h"
 
 //Internal
 #include "DirLocker.h"
-#include "3rd_party/strnatcmp/include/strnatcmp.h"
+#include "Snapshot.h"
 
 //Qt
 #include <QDir>
-#include <QReadWriteLock>
+#include <QFile>
 #include <QProcess>
 #include <QTextCodec>
 #include <QPair>
@@ -43,11 +45,31 @@
 #include <QListIterator>
 #include <QMutex>
 #include <QThreadStorage>
+#include <QThread>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QRunnable>
 
 //CRT
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <cerrno>
 #include <process.h>
+#include <io.h>
+#include <fcntl.h>
+#include <share.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <vector>
+
+//SIMD
+#if defined(_M_IX86) || defined(_M_X64)
+#define TRIM_SIMD 1
+#include <emmintrin.h>
+#else
+#define TRIM_SIMD 0
+#endif
 
 //VLD
 #ifdef _MSC_VER
@@ -57,6 +79,33 @@
 //Global
 const QString MUtils::Internal::g_empty;
 
+///////////////////////////////////////////////////////////////////////////////
+// IPC Names
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Every character outside of [A-Za-z0-9_-] becomes an underscore, then the result is converted to lower case
+ */
+static QString escape_ipc_id(const QString &str)
+{
+	QString result(str);
+	for(QString::Iterator iter = result.begin(); iter != result.end(); iter++)
+	{
+		const ushort c = iter->unicode();
+		if(((c >= 'A') && (c <= 'Z')) || ((c >= 'a') && (c <= 'z')) || ((c >= '0') && (c <= '9')) || (c == '_') || (c == '-'))
+		{
+			continue;
+		}
+		*iter = QLatin1Char('_');
+	}
+	return result.toLower();
+}
+
+QString MUtils::Internal::make_ipc_id(const char *const prefix, const QString &applicationId, const unsigned int &appVersionNo, const QString &scopeId, const QString &itemId)
+{
+	return QString("com.muldersoft.mutilities.%1.%2.r%3.%4.%5").arg(QLatin1String(prefix), escape_ipc_id(applicationId), QString::number(appVersionNo, 16).toUpper(), escape_ipc_id(scopeId), escape_ipc_id(itemId));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Random Support
 ///////////////////////////////////////////////////////////////////////////////
@@ -116,36 +165,144 @@ static quint32 rand_fallback(void)
 	return rnd_val;
 }
 
-quint32 MUtils::next_rand_u32(void)
+/*
+ * Each thread owns a ChaCha20 generator, keyed from the system's CSPRNG. The keystream is produced in batches of a few blocks; the first 32 bytes of each batch immediately replace the key ("fast key erasure") and every byte is wiped once it has been handed out, so that earlier outputs can not be recovered from the state.
+ */
+
+static const size_t RAND_BLOCKS = 4U;
+static const size_t RAND_BUFFER = 64U * RAND_BLOCKS;
+static const size_t RAND_KEYLEN = 32U;
+
+typedef struct
 {
-	quint32 rnd;
-	if (rand_s(&rnd))
+	quint32 key[RAND_KEYLEN / sizeof(quint32)];
+	quint32 buffer[RAND_BUFFER / sizeof(quint32)];
+	size_t avail;
+}
+rand_state_t;
+
+static QThreadStorage<rand_state_t*> g_rand_state;
+
+#define CHACHA_ROTL(X,N) (((X) << (N)) | ((X) >> (32 - (N))))
+#define CHACHA_QR(X,A,B,C,D) do \
+{ \
+	X[A] += X[B]; X[D] ^= X[A]; X[D] = CHACHA_ROTL(X[D], 16); \
+	X[C] += X[D]; X[B] ^= X[C]; X[B] = CHACHA_ROTL(X[B], 12); \
+	X[A] += X[B]; X[D] ^= X[A]; X[D] = CHACHA_ROTL(X[D],  8); \
+	X[C] += X[D]; X[B] ^= X[C]; X[B] = CHACHA_ROTL(X[B],  7); \
+} \
+while(0)
+
+static void chacha20_block(quint32 *const output, const quint32 *const key, const quint32 counter)
+{
+	static const quint32 SIGMA[4] = { 0x61707865, 0x3320646E, 0x79622D32, 0x6B206574 };
+
+	quint32 input[16], x[16];
+	memcpy(&input[0], SIGMA, sizeof(SIGMA));
+	memcpy(&input[4], key, RAND_KEYLEN);
+	input[12] = counter;
+	input[13] = input[14] = input[15] = 0U; /*the key changes for every batch, so a zero nonce is sufficient*/
+	memcpy(x, input, sizeof(x));
+
+	for (size_t round = 0; round < 10; ++round)
+	{
+		CHACHA_QR(x, 0, 4,  8, 12);
+		CHACHA_QR(x, 1, 5,  9, 13);
+		CHACHA_QR(x, 2, 6, 10, 14);
+		CHACHA_QR(x, 3, 7, 11, 15);
+		CHACHA_QR(x, 0, 5, 10, 15);
+		CHACHA_QR(x, 1, 6, 11, 12);
+		CHACHA_QR(x, 2, 7,  8, 13);
+		CHACHA_QR(x, 3, 4,  9, 14);
+	}
+
+	for (size_t i = 0; i < 16; ++i)
+	{
+		output[i] = x[i] + input[i];
+	}
+}
+
+static void rand_refill(rand_state_t *const state)
+{
+	for (size_t block = 0; block < RAND_BLOCKS; ++block)
+	{
+		chacha20_block(&state->buffer[16U * block], state->key, quint32(block));
+	}
+	memcpy(state->key, state->buffer, RAND_KEYLEN);
+	memset(state->buffer, 0, RAND_KEYLEN);
+	state->avail = RAND_BUFFER - RAND_KEYLEN;
+}
+
+static rand_state_t *rand_state(void)
+{
+	rand_state_t *state = g_rand_state.localData();
+	if (!state)
+	{
+		state = new rand_state_t();
+		for (size_t i = 0; i < RAND_KEYLEN / sizeof(quint32); ++i)
+		{
+			quint32 rnd;
+			state->key[i] = rand_s(&rnd) ? rand_fallback() : rnd;
+		}
+		rand_refill(state);
+		g_rand_state.setLocalData(state);
+	}
+	return state;
+}
+
+static __forceinline void rand_read(rand_state_t *const state, quint8 *output, size_t size)
+{
+	while (size > 0)
+	{
+		if (state->avail < 1)
+		{
+			rand_refill(state);
+		}
+		const size_t chunk = qMin(size, state->avail);
+		quint8 *const source = reinterpret_cast<quint8*>(state->buffer) + (RAND_BUFFER - state->avail);
+		memcpy(output, source, chunk);
+		memset(source, 0, chunk);
+		state->avail -= chunk;
+		output += chunk;
+		size -= chunk;
+	}
+}
+
+void MUtils::next_rand_bytes(void *const buffer, const size_t size)
+{
+	if (buffer && (size > 0))
 	{
-		return rand_fallback();
+		rand_read(rand_state(), static_cast<quint8*>(buffer), size);
 	}
+}
+
+quint32 MUtils::next_rand_u32(void)
+{
+	quint32 rnd;
+	rand_read(rand_state(), reinterpret_cast<quint8*>(&rnd), sizeof(quint32));
 	return rnd;
 }
 
 quint32 MUtils::next_rand_u32(const quint32 max)
 {
-	static const uint32_t DIV_LUT[64] =
+	//Lemire's "nearly divisionless" method: unbiased, and a division is only required in rare cases
+	quint64 product = quint64(next_rand_u32()) * quint64(max);
+	if (quint32(product) < max)
 	{
-		0xFFFFFFFF, 0xFFFFFFFF, 0x80000000, 0x55555556, 0x40000000, 0x33333334, 0x2AAAAAAB, 0x24924925,
-		0x20000000, 0x1C71C71D, 0x1999999A, 0x1745D175, 0x15555556, 0x13B13B14, 0x12492493, 0x11111112,
-		0x10000000, 0x0F0F0F10, 0x0E38E38F, 0x0D79435F, 0x0CCCCCCD, 0x0C30C30D, 0x0BA2E8BB, 0x0B21642D,
-		0x0AAAAAAB, 0x0A3D70A4, 0x09D89D8A, 0x097B425F, 0x0924924A, 0x08D3DCB1, 0x08888889, 0x08421085,
-		0x08000000, 0x07C1F07D, 0x07878788, 0x07507508, 0x071C71C8, 0x06EB3E46, 0x06BCA1B0, 0x06906907,
-		0x06666667, 0x063E7064, 0x06186187, 0x05F417D1, 0x05D1745E, 0x05B05B06, 0x0590B217, 0x0572620B,
-		0x05555556, 0x0539782A, 0x051EB852, 0x05050506, 0x04EC4EC5, 0x04D4873F, 0x04BDA130, 0x04A7904B,
-		0x04924925, 0x047DC120, 0x0469EE59, 0x0456C798, 0x04444445, 0x04325C54, 0x04210843, 0x04104105
-	};
-	return (max < 64) ? (next_rand_u32() / DIV_LUT[max]) : (next_rand_u32() / (UINT32_MAX / max + 1U));
+		const quint32 threshold = (0U - max) % max;
+		while (quint32(product) < threshold)
+		{
+			product = quint64(next_rand_u32()) * quint64(max);
+		}
+	}
+	return quint32(product >> 32);
 }
 
-
 quint64 MUtils::next_rand_u64(void)
 {
-	return (quint64(next_rand_u32()) << 32) | quint64(next_rand_u32());
+	quint64 rnd;
+	rand_read(rand_state(), reinterpret_cast<quint8*>(&rnd), sizeof(quint64));
+	return rnd;
 }
 
 QString MUtils::next_rand_str(const bool &bLong)
@@ -164,31 +321,121 @@ QString MUtils::next_rand_str(const bool &bLong)
 // STRING UTILITY FUNCTIONS
 ///////////////////////////////////////////////////////////////////////////////
 
-static QScopedPointer<QRegExp> g_str_trim_rx_r;
-static QScopedPointer<QRegExp> g_str_trim_rx_l;
-static QMutex                  g_str_trim_lock;
+/*
+ * White-space is defined by QChar::isSpace(), which is what the "\s" character class matches. The SIMD loops only skip blocks that consist entirely of ASCII white-space characters; the exact boundary is always determined by the scalar loop, which also handles the non-ASCII white-space characters.
+ */
+
+static __forceinline int trim_skip_fwd(const ushort *const data, int pos, const int len)
+{
+	while ((pos < len) && QChar(data[pos]).isSpace())
+	{
+		++pos;
+	}
+	return pos;
+}
 
-static QString& trim_helper(QString &str, QScopedPointer<QRegExp> &regex, const char *const pattern)
+static __forceinline int trim_skip_bwd(const ushort *const data, int pos)
 {
-	QMutexLocker lock(&g_str_trim_lock);
-	if (regex.isNull())
+	while ((pos > 0) && QChar(data[pos - 1]).isSpace())
 	{
-		regex.reset(new QRegExp(QLatin1String(pattern)));
+		--pos;
 	}
-	str.remove(*regex.data());
-	return str;
+	return pos;
+}
+
+#if TRIM_SIMD
+
+static __forceinline bool trim_all_space_sse2(const ushort *const data)
+{
+	const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+	const __m128i space = _mm_cmpeq_epi16(chars, _mm_set1_epi16(0x20));
+	const __m128i ctrls = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(chars, _mm_set1_epi16(0x09)), _mm_set1_epi16(0x04)), _mm_setzero_si128()); /*0x09 to 0x0D*/
+	return (_mm_movemask_epi8(_mm_or_si128(space, ctrls)) == 0xFFFF);
+}
+
+static int trim_scan_fwd_sse2(const ushort *const data, const int len)
+{
+	int pos = 0;
+	while (((pos + 8) <= len) && trim_all_space_sse2(data + pos))
+	{
+		pos += 8;
+	}
+	return trim_skip_fwd(data, pos, len);
+}
+
+static int trim_scan_bwd_sse2(const ushort *const data, const int len)
+{
+	int pos = len;
+	while ((pos >= 8) && trim_all_space_sse2(data + (pos - 8)))
+	{
+		pos -= 8;
+	}
+	return trim_skip_bwd(data, pos);
+}
+
+#endif //TRIM_SIMD
+
+static int trim_scan_fwd_c(const ushort *const data, const int len)
+{
+	return trim_skip_fwd(data, 0, len);
+}
+
+static int trim_scan_bwd_c(const ushort *const data, const int len)
+{
+	return trim_skip_bwd(data, len);
+}
+
+typedef int (*trim_scan_t)(const ushort *const data, const int len);
+
+static bool trim_select_sse2(void)
+{
+#if TRIM_SIMD
+	return MUTILS_BOOLIFY(MUtils::CPUFetaures::detect().features & MUtils::CPUFetaures::FLAG_SSE2);
+#else
+	return false;
+#endif //TRIM_SIMD
+}
+
+//Returns the index of the first non-white-space character
+static int trim_scan_fwd(const QString &str)
+{
+#if TRIM_SIMD
+	static const trim_scan_t trim_scan_impl = trim_select_sse2() ? trim_scan_fwd_sse2 : trim_scan_fwd_c;
+#else
+	static const trim_scan_t trim_scan_impl = trim_scan_fwd_c;
+#endif //TRIM_SIMD
+	return trim_scan_impl(str.utf16(), str.length());
+}
+
+//Returns the length without the trailing white-space characters
+static int trim_scan_bwd(const QString &str)
+{
+#if TRIM_SIMD
+	static const trim_scan_t trim_scan_impl = trim_select_sse2() ? trim_scan_bwd_sse2 : trim_scan_bwd_c;
+#else
+	static const trim_scan_t trim_scan_impl = trim_scan_bwd_c;
+#endif //TRIM_SIMD
+	return trim_scan_impl(str.utf16(), str.length());
 }
 
 QString& MUtils::trim_right(QString &str)
 {
-	static const char *const TRIM_RIGHT = "\\s+$";
-	return trim_helper(str, g_str_trim_rx_r, TRIM_RIGHT);
+	const int length = trim_scan_bwd(str);
+	if (length < str.length())
+	{
+		str.truncate(length);
+	}
+	return str;
 }
 
 QString& MUtils::trim_left(QString &str)
 {
-	static const char *const TRIM_LEFT = "^\\s+";
-	return trim_helper(str, g_str_trim_rx_l, TRIM_LEFT);
+	const int offset = trim_scan_fwd(str);
+	if (offset > 0)
+	{
+		str.remove(0, offset);
+	}
+	return str;
 }
 
 QString MUtils::trim_right(const QString &str)
@@ -203,10 +450,71 @@ QString MUtils::trim_left(const QString &str)
 	return trim_left(temp);
 }
 
+QStringList& MUtils::trim_right(QStringList &list)
+{
+	for (int i = 0; i < list.count(); ++i)
+	{
+		const int length = trim_scan_bwd(list.at(i));
+		if (length < list.at(i).length())
+		{
+			list[i].truncate(length); /*detach only if modified*/
+		}
+	}
+	return list;
+}
+
+QStringList& MUtils::trim_left(QStringList &list)
+{
+	for (int i = 0; i < list.count(); ++i)
+	{
+		const int offset = trim_scan_fwd(list.at(i));
+		if (offset > 0)
+		{
+			list[i].remove(0, offset); /*detach only if modified*/
+		}
+	}
+	return list;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // GENERATE FILE NAME
 ///////////////////////////////////////////////////////////////////////////////
 
+/*
+ * Creates a new file with a random name, using _O_CREAT|_O_EXCL (i.e. CREATE_NEW), so that checking for existence and creating the file is a *single* atomic operation. Returns the open file descriptor, or -1 on error.
+ */
+static int make_temp_file_helper(const QString &prefix, const QString &extension, QString &fileName)
+{
+	for (int i = 0; i < 4096; i++)
+	{
+		int fd = -1;
+		fileName = QString("%1%2.%3").arg(prefix, MUtils::next_rand_str(), extension);
+		const errno_t error = _wsopen_s(&fd, MUTILS_WCHR(fileName), _O_CREAT | _O_EXCL | _O_RDWR | _O_BINARY | _O_NOINHERIT, _SH_DENYNO, _S_IREAD | _S_IWRITE);
+		if (error == 0)
+		{
+			return fd;
+		}
+		if (error != EEXIST)
+		{
+			qWarning("Failed to create temp file: %s (error %d)", MUTILS_UTF8(fileName), int(error));
+			break;
+		}
+	}
+
+	fileName.clear();
+	return -1;
+}
+
+static QString make_temp_file_prefix(const QDir &basePath)
+{
+	QString prefix = QDir::toNativeSeparators(basePath.absolutePath());
+	if (!prefix.endsWith(QLatin1Char('\\')))
+	{
+		prefix.append(QLatin1Char('\\'));
+	}
+	return prefix;
+}
+
 QString MUtils::make_temp_file(const QString &basePath, const QString &extension, const bool placeholder)
 {
 	return make_temp_file(QDir(basePath), extension, placeholder);
@@ -220,24 +528,25 @@ QString MUtils::make_temp_file(const QDir &basePath, const QString &extension, c
 		return QString();
 	}
 
+	if (placeholder)
+	{
+		QString tempFileName;
+		const int fd = make_temp_file_helper(make_temp_file_prefix(basePath), extension, tempFileName);
+		if (fd >= 0)
+		{
+			_close(fd);
+			return QDir::fromNativeSeparators(tempFileName);
+		}
+		qWarning("Failed to generate temp file name!");
+		return QString();
+	}
+
 	for(int i = 0; i < 4096; i++)
 	{
 		const QString tempFileName = basePath.absoluteFilePath(QString("%1.%2").arg(next_rand_str(), extension));
 		if(!QFileInfo(tempFileName).exists())
 		{
-			if(placeholder)
-			{
-				QFile file(tempFileName);
-				if(file.open(QFile::ReadWrite))
-				{
-					file.close();
-					return tempFileName;
-				}
-			}
-			else
-			{
-				return tempFileName;
-			}
+			return tempFileName;
 		}
 	}
 
@@ -245,6 +554,72 @@ QString MUtils::make_temp_file(const QDir &basePath, const QString &extension, c
 	return QString();
 }
 
+bool MUtils::make_temp_file(QFile &file, const QDir &basePath, const QString &extension)
+{
+	if (extension.isEmpty() || file.isOpen())
+	{
+		qWarning("Cannot create temp file with invalid parameters!");
+		return false;
+	}
+
+	QString tempFileName;
+	const int fd = make_temp_file_helper(make_temp_file_prefix(basePath), extension, tempFileName);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	file.setFileName(QDir::fromNativeSeparators(tempFileName));
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+	if (file.open(fd, QIODevice::ReadWrite, QFileDevice::AutoCloseHandle))
+	{
+		return true;
+	}
+	_close(fd);
+#else
+	_close(fd); /*Qt 4.x can not take ownership of the descriptor, so re-open the file that we have created*/
+	if (file.open(QIODevice::ReadWrite))
+	{
+		return true;
+	}
+#endif
+
+	qWarning("Failed to open temp file: %s", MUTILS_UTF8(tempFileName));
+	_wunlink(MUTILS_WCHR(tempFileName));
+	return false;
+}
+
+QStringList MUtils::make_temp_files(const QDir &basePath, const QString &extension, const quint32 count)
+{
+	QStringList tempFiles;
+	if (extension.isEmpty())
+	{
+		qWarning("Cannot create temp files with invalid parameters!");
+		return tempFiles;
+	}
+
+	const QString prefix = make_temp_file_prefix(basePath);
+	tempFiles.reserve(int(qMin(count, quint32(INT_MAX))));
+	for (quint32 i = 0; i < count; i++)
+	{
+		QString tempFileName;
+		const int fd = make_temp_file_helper(prefix, extension, tempFileName);
+		if (fd < 0)
+		{
+			qWarning("Failed to reserve temp files, rolling back!");
+			for (QStringList::ConstIterator iter = tempFiles.constBegin(); iter != tempFiles.constEnd(); ++iter)
+			{
+				_wunlink(MUTILS_WCHR(QDir::toNativeSeparators(*iter)));
+			}
+			return QStringList();
+		}
+		_close(fd);
+		tempFiles << QDir::fromNativeSeparators(tempFileName);
+	}
+
+	return tempFiles;
+}
+
 QString MUtils::make_unique_file(const QString &basePath, const QString &baseName, const QString &extension, const bool fancy, const bool placeholder)
 {
 	return make_unique_file(QDir(basePath), baseName, extension, fancy, placeholder);
@@ -313,8 +688,7 @@ bool MUtils::parity(quint32 value)
 // TEMP FOLDER
 ///////////////////////////////////////////////////////////////////////////////
 
-static QScopedPointer<MUtils::Internal::DirLock> g_temp_folder_file;
-static QReadWriteLock                            g_temp_folder_lock;
+static MUtils::Internal::Snapshot<MUtils::Internal::DirLock> g_temp_folder_file;
 
 static QString try_create_subfolder(const QString &baseDir, const QString &postfix)
 {
@@ -377,13 +751,13 @@ static bool temp_folder_cleanup_helper(const QString &tempPath)
 
 static void temp_folder_cleaup(void)
 {
-	QWriteLocker writeLock(&g_temp_folder_lock);
+	QMutexLocker lock(&g_temp_folder_file.mutex());
 
 	//Clean the directory
-	while(!g_temp_folder_file.isNull())
+	if(MUtils::Internal::DirLock *const lockFile = g_temp_folder_file.take())
 	{
-		const QString tempPath = g_temp_folder_file->getPath();
-		g_temp_folder_file.reset(NULL);
+		const QString tempPath = lockFile->getPath();
+		delete lockFile;
 		if(!temp_folder_cleanup_helper(tempPath))
 		{
 			MUtils::OS::system_message_wrn(L"Temp Cleaner", L"Warning: Not all temporary files could be removed!");
@@ -391,39 +765,20 @@ static void temp_folder_cleaup(void)
 	}
 }
 
-const QString &MUtils::temp_folder(void)
+static MUtils::Internal::DirLock *init_temp_folder(void)
 {
-	QReadLocker readLock(&g_temp_folder_lock);
-
-	//Already initialized?
-	if(!g_temp_folder_file.isNull())
-	{
-		return g_temp_folder_file->getPath();
-	}
-
-	//Obtain the write lock to initilaize
-	readLock.unlock();
-	QWriteLocker writeLock(&g_temp_folder_lock);
-	
-	//Still uninitilaized?
-	if(!g_temp_folder_file.isNull())
-	{
-		return g_temp_folder_file->getPath();
-	}
-
 	//Try the %TMP% or %TEMP% directory first
 	if(MUtils::Internal::DirLock *lockFile = try_init_temp_folder(QDir::tempPath()))
 	{
-		g_temp_folder_file.reset(lockFile);
 		atexit(temp_folder_cleaup);
-		return lockFile->getPath();
+		return lockFile;
 	}
 
 	qWarning("%%TEMP%% directory not found -> trying fallback mode now!");
-	static const OS::known_folder_t FOLDER_ID[2] = { OS::FOLDER_APPDATA_LOCA, OS::FOLDER_SYSROOT };
+	static const MUtils::OS::known_folder_t FOLDER_ID[2] = { MUtils::OS::FOLDER_APPDATA_LOCA, MUtils::OS::FOLDER_SYSROOT };
 	for(size_t id = 0; id < 2; id++)
 	{
-		const QString &knownFolder = OS::known_folder(FOLDER_ID[id]);
+		const QString &knownFolder = MUtils::OS::known_folder(FOLDER_ID[id]);
 		if(!knownFolder.isEmpty())
 		{
 			const QString tempRoot = try_create_subfolder(knownFolder, QLatin1String("TEMP"));
@@ -431,14 +786,23 @@ const QString &MUtils::temp_folder(void)
 			{
 				if(MUtils::Internal::DirLock *lockFile = try_init_temp_folder(tempRoot))
 				{
-					g_temp_folder_file.reset(lockFile);
 					atexit(temp_folder_cleaup);
-					return lockFile->getPath();
+					return lockFile;
 				}
 			}
 		}
 	}
 
+	return NULL;
+}
+
+const QString &MUtils::temp_folder(void)
+{
+	if(const Internal::DirLock *const lockFile = g_temp_folder_file.once(init_temp_folder))
+	{
+		return lockFile->getPath();
+	}
+
 	qFatal("Temporary directory could not be initialized !!!");
 	return (*((QString*)NULL));
 }
@@ -623,70 +987,387 @@ void MUtils::init_process(QProcess &process, const QString &wokringDir, const bo
 // NATURAL ORDER STRING COMPARISON
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool natural_string_sort_helper(const QString &str1, const QString &str2)
+/*
+ * Each string is converted into a sort key *once*, so that comparisons reduce to memcmp(). The key follows the rules of strnatcmp(): white-space is ignored (except for a quirk of strnatcmp(), which compares the white-space character directly following a run of digits that ends with a zero), runs of digits are compared by their numeric value (then by the number of leading zeros), and runs of digits following a decimal point are compared left-aligned. The raw string is appended, as a tie-breaker. All units are stored as 16-Bit big-endian values.
+ *
+ * Number tokens start with the unit 0x0030, i.e. the code of the '0' character, so that numbers compare to other characters like the digits in strnatcmp() do. Where two primary keys diverge, the next unit is never zero (the 32-Bit lengths always follow a number marker), so the zero unit that separates the primary key from the tie-breaker makes a key sort *before* any key that it is a prefix of.
+ */
+
+static const size_t NATSORT_PARALLEL_THRESHOLD = 16384U;
+
+#define NATSORT_IS_DIGIT(C) (((C) >= L'0') && ((C) <= L'9'))
+#define NATSORT_IS_DECPT(C) (((C) == L'.') || ((C) == L','))
+
+static __forceinline void natsort_put(std::vector<quint8> &key, const quint32 unit)
 {
-	return (MUtils::Internal::NaturalSort::strnatcmp(MUTILS_WCHR(str1), MUTILS_WCHR(str2)) < 0);
+	key.push_back(quint8(unit >> 8));
+	key.push_back(quint8(unit));
 }
 
-static bool natural_string_sort_helper_fold_case(const QString &str1, const QString &str2)
+static __forceinline void natsort_put32(std::vector<quint8> &key, const quint32 value)
 {
-	return (MUtils::Internal::NaturalSort::strnatcasecmp(MUTILS_WCHR(str1), MUTILS_WCHR(str2)) < 0);
+	natsort_put(key, (value >> 16) & 0xFFFF);
+	natsort_put(key, value & 0xFFFF);
+}
+
+static void natsort_make_key(std::vector<quint8> &key, const QString &str, const bool bIgnoreCase)
+{
+	const ushort *const data = str.utf16();
+	const int len = str.length();
+
+	bool fractional = false, keepSpace = false;
+	int pos = 0;
+	while (pos < len)
+	{
+		const ushort c = data[pos];
+		if (QChar(c).isSpace() && (!keepSpace))
+		{
+			++pos;
+			continue;
+		}
+		keepSpace = false;
+		if (NATSORT_IS_DIGIT(c))
+		{
+			const int start = pos;
+			natsort_put(key, L'0');
+			if (fractional)
+			{
+				while ((pos < len) && NATSORT_IS_DIGIT(data[pos]))
+				{
+					natsort_put(key, data[pos++]);
+				}
+				natsort_put(key, 0x0001); /*shorter run sorts first*/
+				keepSpace = (pos - start > 1) && (data[pos - 1] == L'0');
+			}
+			else
+			{
+				int zeros = 0, end;
+				while ((pos < len) && (data[pos] == L'0'))
+				{
+					++zeros; ++pos;
+				}
+				for (end = pos; (end < len) && NATSORT_IS_DIGIT(data[end]); ++end) {}
+				natsort_put32(key, quint32(end - pos) + 1U);
+				while (pos < end)
+				{
+					natsort_put(key, data[pos++]);
+				}
+				natsort_put32(key, quint32(zeros) + 1U);
+				keepSpace = (data[pos - 1] == L'0');
+			}
+			fractional = false;
+			continue;
+		}
+		const ushort unit = bIgnoreCase ? QChar(c).toUpper().unicode() : c;
+		natsort_put(key, unit ? unit : 0x0001);
+		fractional = NATSORT_IS_DECPT(c);
+		++pos;
+	}
+
+	//Tie-breaker, like wcscmp() or _wcsicmp(), followed by the raw string
+	natsort_put(key, 0x0000);
+	if (bIgnoreCase)
+	{
+		for (int i = 0; i < len; ++i)
+		{
+			natsort_put(key, QChar(data[i]).toLower().unicode());
+		}
+		natsort_put(key, 0x0000);
+	}
+	for (int i = 0; i < len; ++i)
+	{
+		natsort_put(key, data[i]);
+	}
+}
+
+#undef NATSORT_IS_DIGIT
+#undef NATSORT_IS_DECPT
+
+QByteArray MUtils::natural_sort_key(const QString &str, const bool bIgnoreCase)
+{
+	std::vector<quint8> key;
+	key.reserve(2U * (3U * str.length() + 8U));
+	natsort_make_key(key, str, bIgnoreCase);
+	return key.empty() ? QByteArray() : QByteArray(reinterpret_cast<const char*>(&key[0]), int(key.size()));
+}
+
+typedef struct
+{
+	size_t offset;
+	size_t length;
+	const quint8 *key;
+	int index;
+}
+natsort_entry_t;
+
+static bool natsort_less(const natsort_entry_t &a, const natsort_entry_t &b)
+{
+	const int result = memcmp(a.key, b.key, qMin(a.length, b.length));
+	return (result != 0) ? (result < 0) : (a.length < b.length);
+}
+
+static void natsort_sort_range(const QStringList &list, std::vector<natsort_entry_t> &entries, std::vector<quint8> &arena, const size_t begin, const size_t end, const bool bIgnoreCase)
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		const size_t offset = arena.size();
+		natsort_make_key(arena, list.at(int(i)), bIgnoreCase);
+		entries[i].offset = offset;
+		entries[i].length = arena.size() - offset;
+		entries[i].index = int(i);
+	}
+	for (size_t i = begin; i < end; ++i)
+	{
+		entries[i].key = &arena[entries[i].offset]; /*arena is complete now*/
+	}
+	std::sort(entries.begin() + begin, entries.begin() + end, natsort_less);
+}
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		class NatSortTask : public QRunnable
+		{
+		public:
+			NatSortTask(const std::function<void(void)> &work) : m_work(work) { }
+
+			virtual void run(void)
+			{
+				m_work();
+			}
+
+		private:
+			const std::function<void(void)> m_work;
+		};
+	}
 }
 
 void MUtils::natural_string_sort(QStringList &list, const bool bIgnoreCase)
 {
-	qSort(list.begin(), list.end(), bIgnoreCase ? natural_string_sort_helper_fold_case : natural_string_sort_helper);
+	const size_t count = size_t(list.count());
+	if (count < 2)
+	{
+		return;
+	}
+
+	std::vector<natsort_entry_t> entries(count);
+	const size_t threads = (count >= NATSORT_PARALLEL_THRESHOLD) ? size_t(qBound(1, QThread::idealThreadCount(), 32)) : 1U;
+	std::vector<std::vector<quint8>> arenas(threads);
+
+	//Build keys and sort each chunk
+	std::vector<size_t> bounds(threads + 1U);
+	for (size_t t = 0; t <= threads; ++t)
+	{
+		bounds[t] = (count * t) / threads;
+	}
+	if (threads > 1)
+	{
+		QThreadPool pool;
+		pool.setMaxThreadCount(int(threads));
+		for (size_t t = 0; t < threads; ++t)
+		{
+			pool.start(new Internal::NatSortTask([&, t]() { natsort_sort_range(list, entries, arenas[t], bounds[t], bounds[t + 1], bIgnoreCase); }));
+		}
+		pool.waitForDone();
+
+		//Merge the sorted chunks pairwise, in parallel
+		for (size_t width = 1; width < threads; width *= 2)
+		{
+			for (size_t t = 0; t + width < threads; t += 2 * width)
+			{
+				const size_t lower = bounds[t], middle = bounds[t + width], upper = bounds[qMin(t + 2 * width, threads)];
+				pool.start(new Internal::NatSortTask([&entries, lower, middle, upper]() { std::inplace_merge(entries.begin() + lower, entries.begin() + middle, entries.begin() + upper, natsort_less); }));
+			}
+			pool.waitForDone();
+		}
+	}
+	else
+	{
+		natsort_sort_range(list, entries, arenas[0], 0, count, bIgnoreCase);
+	}
+
+	QStringList sorted;
+	sorted.reserve(int(count));
+	for (std::vector<natsort_entry_t>::const_iterator iter = entries.begin(); iter != entries.end(); ++iter)
+	{
+		sorted << list.at(iter->index);
+	}
+	list.swap(sorted);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // CLEAN FILE PATH
 ///////////////////////////////////////////////////////////////////////////////
 
-static QMutex                                              g_clean_file_name_mutex;
-static QScopedPointer<const QList<QPair<QRegExp,QString>>> g_clean_file_name_regex;
+/*
+ * The "pretty" mode used to apply a list of regular expressions, followed by simplified(), until the string did not change anymore. The functions below produce the identical result in a single pass:
+ * (1) Straight double quotes are handled at most once, because no new straight double quotes are ever created.
+ * (2) On the *raw* string, the first step that applies is one of: strip leading separators, strip trailing separators, replace all separator runs.
+ * (3) After that, the string is simplified, and the iteration converges to: strip all leading and trailing separator/white-space characters, then replace each run of separator/white-space characters that contains a separator by " - ".
+ */
 
-static void clean_file_name_make_pretty(QString &str)
+#define CLEAN_IS_SEP(C) (((C) == QLatin1Char('\\')) || ((C) == QLatin1Char('/')) || ((C) == QLatin1Char(':')))
+
+static QString clean_file_name_replace_seps(const QString &str)
 {
-	static const struct { const char *p; const char *r; } PATTERN[] =
+	static const QLatin1String SEPARATOR(" - ");
+
+	QString result;
+	result.reserve(str.length() + 8);
+
+	const int len = str.length();
+	int pos = 0;
+	while (pos < len)
 	{
-		{ "^\\s*\"([^\"]*)\"\\s*$",    "\\1"                         },  //Remove straight double quotes around the whole string
-		{ "\"([^\"]*)\"",              "\xE2\x80\x9C\\1\xE2\x80\x9D" },  //Replace remaining pairs of straight double quotes with opening/closing double quote
-		{ "^[\\\\/:]+([^\\\\/:]+.*)$", "\\1"                         },  //Remove leading slash, backslash and colon characters
-		{ "^(.*[^\\\\/:]+)[\\\\/:]+$", "\\1"                         },  //Remove trailing slash, backslash and colon characters
-		{ "(\\s*[\\\\/:]\\s*)+",       " - "                         },  //Replace any slash, backslash or colon character that appears in the middle
-		{ NULL, NULL }
-	};
+		const QChar c = str.at(pos);
+		if (!(c.isSpace() || CLEAN_IS_SEP(c)))
+		{
+			result += c;
+			++pos;
+			continue;
+		}
+		int end = pos;
+		bool haveSep = false;
+		while ((end < len) && (str.at(end).isSpace() || CLEAN_IS_SEP(str.at(end))))
+		{
+			haveSep = haveSep || CLEAN_IS_SEP(str.at(end));
+			++end;
+		}
+		if (haveSep)
+		{
+			result += SEPARATOR;
+		}
+		else
+		{
+			result += str.midRef(pos, end - pos);
+		}
+		pos = end;
+	}
+
+	return result;
+}
 
-	QMutexLocker locker(&g_clean_file_name_mutex);
+static QString clean_file_name_simplified_seps(const QString &str)
+{
+	int first = -1, last = -1;
+	bool haveSep = false;
+	for (int i = 0; i < str.length(); ++i)
+	{
+		const QChar c = str.at(i);
+		if (CLEAN_IS_SEP(c))
+		{
+			haveSep = true;
+		}
+		else if (!c.isSpace())
+		{
+			first = (first < 0) ? i : first;
+			last = i;
+		}
+	}
+
+	if (!haveSep)
+	{
+		return str;
+	}
+	if (first < 0)
+	{
+		return QString(QLatin1Char('-'));
+	}
+
+	return clean_file_name_replace_seps(str.mid(first, last - first + 1));
+}
+
+static void clean_file_name_make_pretty(QString &str)
+{
+	if (str.isEmpty())
+	{
+		return;
+	}
 
-	if (g_clean_file_name_regex.isNull())
+	int quotes = 0, first = -1, last = -1;
+	for (int i = 0; i < str.length(); ++i)
 	{
-		QScopedPointer<QList<QPair<QRegExp, QString>>> list(new QList<QPair<QRegExp, QString>>());
-		for (size_t i = 0; PATTERN[i].p; ++i)
+		const QChar c = str.at(i);
+		if (c == QLatin1Char('"'))
+		{
+			++quotes;
+		}
+		if (!c.isSpace())
 		{
-			list->append(qMakePair(QRegExp(QString::fromUtf8(PATTERN[i].p), Qt::CaseInsensitive), PATTERN[i].r ? QString::fromUtf8(PATTERN[i].r) : QString()));
+			first = (first < 0) ? i : first;
+			last = i;
 		}
-		g_clean_file_name_regex.reset(list.take());
 	}
 
-	bool keepOnGoing = !str.isEmpty();
-	while(keepOnGoing)
+	if ((quotes == 2) && (str.at(first) == QLatin1Char('"')) && (str.at(last) == QLatin1Char('"')))
 	{
-		const QString prev = str;
-		keepOnGoing = false;
-		for (QList<QPair<QRegExp, QString>>::ConstIterator iter = g_clean_file_name_regex->constBegin(); iter != g_clean_file_name_regex->constEnd(); ++iter)
+		//Remove straight double quotes around the whole string
+		str = str.mid(first + 1, last - first - 1).simplified();
+	}
+	else if (quotes >= 2)
+	{
+		//Replace pairs of straight double quotes with opening/closing double quote
+		bool opening = true;
+		for (QString::Iterator iter = str.begin(); (iter != str.end()) && (quotes > (opening ? 1 : 0)); ++iter)
 		{
-			str.replace(iter->first, iter->second);
-			if (str.compare(prev))
+			if (*iter == QLatin1Char('"'))
 			{
-				str = str.simplified();
-				keepOnGoing = !str.isEmpty();
-				break;
+				*iter = opening ? QChar(0x201C) : QChar(0x201D);
+				opening = !opening;
+				--quotes;
 			}
 		}
+		str = str.simplified();
 	}
+	else
+	{
+		const int len = str.length();
+		int lead = 0, trail = len;
+		bool haveSep = false, haveOther = false;
+		while ((lead < len) && CLEAN_IS_SEP(str.at(lead)))
+		{
+			++lead;
+		}
+		while ((trail > 0) && CLEAN_IS_SEP(str.at(trail - 1)))
+		{
+			--trail;
+		}
+		for (int i = 0; i < len; ++i)
+		{
+			if (CLEAN_IS_SEP(str.at(i)))
+			{
+				haveSep = true;
+			}
+			else
+			{
+				haveOther = true;
+			}
+		}
+		if (!haveSep)
+		{
+			return; /*nothing to do*/
+		}
+		if ((lead > 0) && (lead < len))
+		{
+			str = str.mid(lead).simplified();
+		}
+		else if ((trail < len) && haveOther)
+		{
+			str = str.left(trail).simplified();
+		}
+		else
+		{
+			str = clean_file_name_replace_seps(str).simplified();
+			return;
+		}
+	}
+
+	str = clean_file_name_simplified_seps(str);
 }
 
+#undef CLEAN_IS_SEP
+
 QString MUtils::clean_file_name(const QString &name, const bool &pretty)
 {
 	static const QLatin1Char REPLACEMENT_CHAR('_');
@@ -704,38 +1385,55 @@ QString MUtils::clean_file_name(const QString &name, const bool &pretty)
 		clean_file_name_make_pretty(result);
 	}
 
-	for(QString::Iterator iter = result.begin(); iter != result.end(); iter++)
+	//Replace control characters and illegal characters
+	int length = 0;
+	for (int i = 0; i < result.length(); ++i)
 	{
-		if (iter->category() == QChar::Other_Control)
+		const QChar c = result.at(i);
+		if ((c.category() == QChar::Other_Control) || ((c.unicode() > 0) && (c.unicode() < 0x80) && strchr(FILENAME_ILLEGAL_CHARS, c.toLatin1())))
 		{
-			*iter = REPLACEMENT_CHAR;
+			result[i] = REPLACEMENT_CHAR;
+		}
+		if (!(result.at(i).isSpace() || (result.at(i) == QLatin1Char('.'))))
+		{
+			length = i + 1;
 		}
-	}
-		
-	for(size_t i = 0; FILENAME_ILLEGAL_CHARS[i]; i++)
-	{
-		result.replace(QLatin1Char(FILENAME_ILLEGAL_CHARS[i]), REPLACEMENT_CHAR);
-	}
-	
-	trim_right(result);
-	while (result.endsWith(QLatin1Char('.')))
-	{
-		result.chop(1);
-		trim_right(result);
 	}
 
-	for (size_t i = 0; FILENAME_RESERVED_NAMES[i]; i++)
+	//Remove trailing white-space and dot characters
+	result.truncate(length);
+
+	//Replace reserved names
+	const int stemLength = result.indexOf(QLatin1Char('.'));
+	const QString stem = (stemLength < 0) ? result : result.left(stemLength);
+	if ((stem.length() == 3) || (stem.length() == 4))
 	{
-		const QString reserved = QString::fromLatin1(FILENAME_RESERVED_NAMES[i]);
-		if ((!result.compare(reserved, Qt::CaseInsensitive)) || result.startsWith(reserved + QLatin1Char('.'), Qt::CaseInsensitive))
+		for (size_t i = 0; FILENAME_RESERVED_NAMES[i]; i++)
 		{
-			result.replace(0, reserved.length(), QString().leftJustified(reserved.length(), REPLACEMENT_CHAR));
+			if (!stem.compare(QLatin1String(FILENAME_RESERVED_NAMES[i]), Qt::CaseInsensitive))
+			{
+				result.replace(0, stem.length(), QString(stem.length(), REPLACEMENT_CHAR));
+				break;
+			}
 		}
 	}
 
 	return result;
 }
 
+QStringList& MUtils::clean_file_name(QStringList &names, const bool &pretty)
+{
+	for (int i = 0; i < names.count(); ++i)
+	{
+		const QString cleaned = clean_file_name(names.at(i), pretty);
+		if (cleaned != names.at(i))
+		{
+			names[i] = cleaned; /*detach only if modified*/
+		}
+	}
+	return names;
+}
+
 static QPair<QString,QString> clean_file_path_get_prefix(const QString path)
 {
 	static const char *const PREFIXES[] =
@@ -935,6 +1633,116 @@ MUtils::fp_parts_t MUtils::break_fp(const double value)
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// LAZY INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Threads that wait for a lazy initializer are parked on a condition variable, selected by the address of the state. The state is changed *before* the mutex is taken to wake up the waiters, and the waiters check it *while* holding the mutex, so a wake-up can not be missed.
+ */
+
+static const size_t LAZY_SPIN_COUNT = 64;
+static const size_t LAZY_BUCKETS = 16;
+
+static struct
+{
+	QMutex mutex;
+	QWaitCondition cond;
+}
+g_lazy_buckets[LAZY_BUCKETS];
+
+#define LAZY_BUCKET(STATE) (g_lazy_buckets[(reinterpret_cast<quintptr>(&(STATE)) >> 4) % LAZY_BUCKETS])
+
+bool MUtils::Internal::lazy_begin(QAtomicInt &state)
+{
+	size_t spin = 0;
+	forever
+	{
+		if(state.testAndSetOrdered(LAZY_IDLE, LAZY_BUSY))
+		{
+			return true; /*this thread runs the initializer*/
+		}
+		if(state == LAZY_DONE)
+		{
+			return false;
+		}
+		if(spin++ < LAZY_SPIN_COUNT)
+		{
+			QThread::yieldCurrentThread();
+			continue;
+		}
+		if(state.testAndSetOrdered(LAZY_BUSY, LAZY_WAIT) || (state == LAZY_WAIT))
+		{
+			QMutexLocker lock(&LAZY_BUCKET(state).mutex);
+			while(state == LAZY_WAIT)
+			{
+				LAZY_BUCKET(state).cond.wait(&LAZY_BUCKET(state).mutex);
+			}
+		}
+	}
+}
+
+void MUtils::Internal::lazy_end(QAtomicInt &state, const bool success)
+{
+	if(state.fetchAndStoreOrdered(success ? LAZY_DONE : LAZY_IDLE) == LAZY_WAIT)
+	{
+		QMutexLocker lock(&LAZY_BUCKET(state).mutex);
+		LAZY_BUCKET(state).cond.wakeAll();
+	}
+}
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		class LazyTask : public QRunnable
+		{
+		public:
+			LazyTask(QAtomicInt &task, const std::function<void(void)> &work) : m_task(task), m_work(work) { }
+
+			virtual void run(void)
+			{
+				try
+				{
+					m_work();
+				}
+				catch (...)
+				{
+					/*the next access will throw again*/
+				}
+				auto &bucket = LAZY_BUCKET(m_task); /*owner may be destroyed as soon as the state is set*/
+				QMutexLocker lock(&bucket.mutex);
+				m_task.fetchAndStoreOrdered(LAZY_TASK_DONE);
+				bucket.cond.wakeAll();
+			}
+
+		private:
+			QAtomicInt &m_task;
+			const std::function<void(void)> m_work;
+		};
+	}
+}
+
+void MUtils::Internal::lazy_prefetch(QAtomicInt &task, const std::function<void(void)> &work)
+{
+	if(task.testAndSetOrdered(LAZY_TASK_NONE, LAZY_TASK_PEND))
+	{
+		QThreadPool::globalInstance()->start(new LazyTask(task, work));
+	}
+}
+
+void MUtils::Internal::lazy_join(QAtomicInt &task)
+{
+	if(task == LAZY_TASK_PEND)
+	{
+		QMutexLocker lock(&LAZY_BUCKET(task).mutex);
+		while(task == LAZY_TASK_PEND)
+		{
+			LAZY_BUCKET(task).cond.wait(&LAZY_BUCKET(task).mutex);
+		}
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // INITIALIZER
 ///////////////////////////////////////////////////////////////////////////////
@@ -72,16 +72,10 @@ private:
 MUtils::Hash::Blake2::Blake2(const char *const key)
 :
 	m_context(new Blake2_Context()),
+	m_key(key),
 	m_finalized(false)
 {
-	if(key && key[0])
-	{
-		blake2b_init_key(m_context->state, HASH_SIZE, key, (uint8_t)strlen(key));
-	}
-	else
-	{
-		blake2b_init(m_context->state, HASH_SIZE);
-	}
+	restart();
 }
 
 MUtils::Hash::Blake2::~Blake2(void)
@@ -107,6 +101,20 @@ bool MUtils::Hash::Blake2::process(const quint8 *const data, const quint32 len)
 	return true;
 }
 
+bool MUtils::Hash::Blake2::restart(void)
+{
+	if(!m_key.isEmpty())
+	{
+		blake2b_init_key(m_context->state, HASH_SIZE, m_key.constData(), (uint8_t)m_key.size());
+	}
+	else
+	{
+		blake2b_init(m_context->state, HASH_SIZE);
+	}
+	m_finalized = false;
+	return true;
+}
+
 QByteArray MUtils::Hash::Blake2::finalize(void)
 {
 	QByteArray result(HASH_SIZE, '\0');
@@ -56,10 +56,12 @@ namespace MUtils
 
 		private:
 			Blake2_Context *const m_context;
+			const QByteArray m_key;
 			bool m_finalized;
 
 			virtual bool process(const quint8 *const data, const quint32 len);
 			virtual QByteArray finalize(void);
+			virtual bool restart(void);
 		};
 		
 	}
@@ -58,6 +58,7 @@
 MUtils::Hash::Keccak::Keccak()
 {
 	m_initialized = false;
+	m_hashBits = hb256;
 	m_state = (MUtils::Hash::Internal::KeccakImpl::hashState*) _aligned_malloc(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
 	if(!m_state)
 	{
@@ -101,10 +102,21 @@ bool MUtils::Hash::Keccak::init(const HashBits hashBits)
 		return false;
 	}
 	
+	m_hashBits = hashBits;
 	m_initialized = true;
 	return true;
 }
 
+bool MUtils::Hash::Keccak::restart(void)
+{
+	m_initialized = false;
+	if (!init(m_hashBits))
+	{
+		return false;
+	}
+	return m_key.isEmpty() ? true : process(((const quint8*)m_key.constData()), quint32(m_key.size()));
+}
+
 
 bool MUtils::Hash::Keccak::process(const quint8 *const data, const quint32 len)
 {
@@ -155,6 +167,7 @@ MUtils::Hash::Keccak *MUtils::Hash::Keccak::create(const HashBits hashBit, const
 	}
 	if (key)
 	{
+		keccak->m_key = QByteArray(key);
 		keccak->update(((const Internal::KeccakImpl::UINT8*)key), strlen(key));
 	}
 	return keccak;
@@ -111,10 +111,13 @@ namespace MUtils
 
 		protected:
 			bool m_initialized;
+			HashBits m_hashBits;
+			QByteArray m_key;
 			Internal::KeccakImpl::hashState *m_state;
 
 			virtual bool process(const quint8 *const data, const quint32 len);
 			virtual QByteArray finalize(void);
+			virtual bool restart(void);
 		};
 	}
 };
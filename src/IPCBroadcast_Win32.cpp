@@ -0,0 +1,407 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//Internal
+#include "IPCBroadcast_Win32.h"
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+//CRT
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTANTS
+///////////////////////////////////////////////////////////////////////////////
+
+static const quint32 BCAST_MAGIC = 0x54534342; //"BCST"
+static const size_t  CACHE_LINE  = 64U;
+static const quint32 SPIN_COUNT  = 256U;
+static const quint32 SLOT_HEADER = 8U;
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+typedef struct
+{
+	volatile LONG owner;
+	volatile LONG sleeping;
+}
+subscriber_t;
+
+/*
+ * Each slot starts with a "stamp" and the length of the message, whose upper 8 bits hold the index of the subscriber that has sent the message. The stamp is set to (position - 1) while the slot is being written and to (position) once the message has been published, so a subscriber can tell whether the slot is not published yet, holds the expected message or has already been overwritten.
+ */
+typedef struct
+{
+	quint32       magic;
+	quint32       slot_count;
+	quint32       slot_size;
+	quint32       reserved;
+	quint8        padding0[CACHE_LINE - (4U * sizeof(quint32))];
+	volatile LONG pos_wr;
+	quint8        padding1[CACHE_LINE - sizeof(LONG)];
+	volatile LONG sleepers;
+	quint8        padding2[CACHE_LINE - sizeof(LONG)];
+	subscriber_t  subscribers[MUtils::Internal::IPCBroadcast::MAX_SUBSCRIBERS];
+}
+bcast_header_t;
+
+#define HEADER (reinterpret_cast<bcast_header_t*>(m_header))
+#define SLOT(X) (m_slots + (size_t((X) & (m_slotCount - 1U)) * m_slotSize))
+#define STAMP(X) (reinterpret_cast<volatile LONG*>(X))
+#define LENGTH(X) (reinterpret_cast<volatile LONG*>(X) + 1U)
+
+static inline bool VALID_GEOMETRY(const quint32 slotCount, const quint32 slotSize)
+{
+	return (slotCount >= 2U) && (!(slotCount & (slotCount - 1U))) && (slotSize >= (2U * SLOT_HEADER)) && (!(slotSize & 7U));
+}
+
+static bool PROCESS_ALIVE(const DWORD processId)
+{
+	if (const HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, processId))
+	{
+		const bool alive = (WaitForSingleObject(process, 0) == WAIT_TIMEOUT);
+		CloseHandle(process);
+		return alive;
+	}
+	return (GetLastError() != ERROR_INVALID_PARAMETER);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::Internal::IPCBroadcast::IPCBroadcast(void)
+:
+	m_slotCount(0U),
+	m_slotSize(0U),
+	m_subscriber(MAX_SUBSCRIBERS),
+	m_header(NULL),
+	m_slots(NULL),
+	m_cursor(0),
+	m_dropped(0)
+{
+	for (quint32 i = 0; i < MAX_SUBSCRIBERS; ++i)
+	{
+		m_events[i] = NULL;
+	}
+}
+
+MUtils::Internal::IPCBroadcast::~IPCBroadcast(void)
+{
+	unsubscribe();
+	for (quint32 i = 0; i < MAX_SUBSCRIBERS; ++i)
+	{
+		if (m_events[i])
+		{
+			CloseHandle(m_events[i]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+size_t MUtils::Internal::IPCBroadcast::required_size(const quint32 slotCount, const quint32 slotSize)
+{
+	return sizeof(bcast_header_t) + (size_t(slotCount) * slotSize);
+}
+
+bool MUtils::Internal::IPCBroadcast::create(void *const buffer, const size_t size, const quint32 slotCount, const quint32 slotSize, const QString &wakeupId)
+{
+	if ((!VALID_GEOMETRY(slotCount, slotSize)) || (size < required_size(slotCount, slotSize)))
+	{
+		qWarning("Invalid broadcast geometry has been specified!");
+		return false;
+	}
+
+	setup(buffer, slotCount, slotSize);
+
+	memset(HEADER, 0, sizeof(bcast_header_t));
+	HEADER->slot_count = slotCount;
+	HEADER->slot_size = slotSize;
+	for (quint32 i = 0; i < slotCount; ++i)
+	{
+		*STAMP(SLOT(i)) = LONG(i - 1U);
+		*LENGTH(SLOT(i)) = 0;
+	}
+
+	MemoryBarrier();
+	HEADER->magic = BCAST_MAGIC;
+	return open(wakeupId);
+}
+
+bool MUtils::Internal::IPCBroadcast::attach(void *const buffer, const size_t size, const QString &wakeupId)
+{
+	const bcast_header_t *const header = reinterpret_cast<const bcast_header_t*>(buffer);
+	if ((size < sizeof(bcast_header_t)) || (header->magic != BCAST_MAGIC))
+	{
+		qWarning("Broadcast header is missing or corrupted!");
+		return false;
+	}
+
+	const quint32 slotCount = header->slot_count, slotSize = header->slot_size;
+	if ((!VALID_GEOMETRY(slotCount, slotSize)) || (size < required_size(slotCount, slotSize)))
+	{
+		qWarning("Broadcast geometry verification has failed!");
+		return false;
+	}
+
+	setup(buffer, slotCount, slotSize);
+	return open(wakeupId);
+}
+
+void MUtils::Internal::IPCBroadcast::setup(void *const buffer, const quint32 slotCount, const quint32 slotSize)
+{
+	m_header = buffer;
+	m_slotCount = slotCount;
+	m_slotSize = slotSize;
+	m_slots = reinterpret_cast<quint8*>(buffer) + sizeof(bcast_header_t);
+}
+
+bool MUtils::Internal::IPCBroadcast::open(const QString &wakeupId)
+{
+	m_wakeupId = wakeupId;
+	subscribe();
+	if (subscribed())
+	{
+		const QString name(QString("%1_s%2").arg(m_wakeupId, QString::number(m_subscriber)));
+		m_events[m_subscriber] = CreateEventW(NULL, FALSE, FALSE, MUTILS_WCHR(name));
+		if (!m_events[m_subscriber])
+		{
+			qWarning("Failed to create event \"%s\" (error: %u)", MUTILS_UTF8(name), GetLastError());
+			return false;
+		}
+	}
+	else
+	{
+		qWarning("Maximum number of broadcast subscribers exceeded, can only send!");
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SUBSCRIBER TABLE
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Entries that are still owned by a process that no longer exists (e.g. because it has crashed) will be reclaimed
+ */
+void MUtils::Internal::IPCBroadcast::subscribe(void)
+{
+	const LONG processId = LONG(GetCurrentProcessId());
+	for (quint32 i = 0; i < MAX_SUBSCRIBERS; ++i)
+	{
+		subscriber_t &entry = HEADER->subscribers[i];
+		const LONG owner = entry.owner;
+		if ((owner != 0) && ((owner == processId) || PROCESS_ALIVE(DWORD(owner))))
+		{
+			continue;
+		}
+		if (InterlockedCompareExchange(&entry.owner, processId, owner) == owner)
+		{
+			if (InterlockedExchange(&entry.sleeping, 0) != 0)
+			{
+				InterlockedDecrement(&HEADER->sleepers);
+			}
+			m_subscriber = i;
+			m_cursor = HEADER->pos_wr;
+			return;
+		}
+	}
+}
+
+void MUtils::Internal::IPCBroadcast::unsubscribe(void)
+{
+	if (subscribed())
+	{
+		InterlockedExchange(&HEADER->subscribers[m_subscriber].owner, 0);
+		m_subscriber = MAX_SUBSCRIBERS;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WRITER
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The writers never block: the slot is claimed even if some subscribers have not read its previous content yet
+ */
+quint8 *MUtils::Internal::IPCBroadcast::reserve(quint32 &position)
+{
+	position = quint32(InterlockedIncrement(&HEADER->pos_wr)) - 1U;
+	quint8 *const slot = SLOT(position);
+	InterlockedExchange(STAMP(slot), LONG(position - 1U));
+	return slot + SLOT_HEADER;
+}
+
+void MUtils::Internal::IPCBroadcast::publish(const quint32 position, const quint32 length)
+{
+	quint8 *const slot = SLOT(position);
+	*LENGTH(slot) = LONG((m_subscriber << 24) | qMin(length, maxLength()));
+	InterlockedExchange(STAMP(slot), LONG(position));
+	wake();
+}
+
+/*
+ * Must be called *after* the stamp has been updated by an interlocked (i.e. fully fenced) operation
+ * Events are opened on first use; concurrent writers race with InterlockedCompareExchangePointer() and the loser closes its handle again
+ */
+void MUtils::Internal::IPCBroadcast::wake(void)
+{
+	if (HEADER->sleepers > 0)
+	{
+		for (quint32 i = 0; i < MAX_SUBSCRIBERS; ++i)
+		{
+			if (HEADER->subscribers[i].sleeping)
+			{
+				if (!m_events[i])
+				{
+					const QString name(QString("%1_s%2").arg(m_wakeupId, QString::number(i)));
+					if (const HANDLE event = CreateEventW(NULL, FALSE, FALSE, MUTILS_WCHR(name)))
+					{
+						if (InterlockedCompareExchangePointer(&m_events[i], event, NULL) != NULL)
+						{
+							CloseHandle(event); /*another writer was faster*/
+						}
+					}
+				}
+				if (m_events[i])
+				{
+					SetEvent(m_events[i]);
+				}
+			}
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SUBSCRIBER
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Spin for a short while, then mark our entry as "sleeping" and re-check before actually blocking on the event, so no wake-up can get lost
+ */
+bool MUtils::Internal::IPCBroadcast::read(quint8 *const buffer, quint32 &length, const quint32 timeout)
+{
+	if (!subscribed())
+	{
+		qWarning("Not subscribed to the broadcast, unable to read!");
+		return false;
+	}
+
+	for (quint32 spin = 0; spin < SPIN_COUNT; ++spin)
+	{
+		if (tryRead(buffer, length))
+		{
+			return true;
+		}
+		if (timeout < 1U)
+		{
+			return false; /*non-blocking*/
+		}
+		YieldProcessor();
+	}
+
+	subscriber_t &entry = HEADER->subscribers[m_subscriber];
+	const DWORD startTime = GetTickCount();
+	forever
+	{
+		InterlockedIncrement(&HEADER->sleepers);
+		InterlockedExchange(&entry.sleeping, 1);
+		if (tryRead(buffer, length))
+		{
+			InterlockedExchange(&entry.sleeping, 0);
+			InterlockedDecrement(&HEADER->sleepers);
+			return true;
+		}
+
+		DWORD waitTime = INFINITE;
+		if (timeout != INFINITE_TIMEOUT)
+		{
+			const DWORD elapsed = GetTickCount() - startTime;
+			waitTime = (elapsed < timeout) ? (timeout - elapsed) : 0U;
+		}
+
+		const DWORD result = (waitTime > 0U) ? WaitForSingleObject(m_events[m_subscriber], waitTime) : WAIT_TIMEOUT;
+		InterlockedExchange(&entry.sleeping, 0);
+		InterlockedDecrement(&HEADER->sleepers);
+
+		if (result != WAIT_OBJECT_0)
+		{
+			if (result != WAIT_TIMEOUT)
+			{
+				qWarning("Failed to wait for event (error: %u)", GetLastError());
+			}
+			return tryRead(buffer, length);
+		}
+	}
+}
+
+/*
+ * The message is copied out of the slot and the stamp is checked once more afterwards, because the writers may overwrite the slot at any time. If the slot has already been overwritten, we have been lapped and continue with the oldest message that is still available.
+ */
+bool MUtils::Internal::IPCBroadcast::tryRead(quint8 *const buffer, quint32 &length)
+{
+	forever
+	{
+		const quint32 cursor = quint32(m_cursor);
+		quint8 *const slot = SLOT(cursor);
+		const qint32 diff = qint32(quint32(*STAMP(slot)) - cursor);
+		if (diff < 0)
+		{
+			return false; /*nothing new*/
+		}
+
+		if (diff == 0)
+		{
+			const quint32 value = quint32(*LENGTH(slot)), len = qMin(value & 0xFFFFFFU, maxLength());
+			const bool own = ((value >> 24) == m_subscriber);
+			if (!own)
+			{
+				memcpy(buffer, slot + SLOT_HEADER, len);
+			}
+			MemoryBarrier();
+			if (quint32(*STAMP(slot)) == cursor)
+			{
+				if ((quint32(InterlockedCompareExchange(&m_cursor, LONG(cursor + 1U), LONG(cursor))) == cursor) && (!own))
+				{
+					length = len;
+					return true;
+				}
+				continue; /*skip our own message*/
+			}
+		}
+
+		const quint32 oldest = quint32(HEADER->pos_wr) - m_slotCount;
+		const quint32 next = (qint32(oldest - cursor) > 0) ? oldest : (cursor + 1U);
+		if (quint32(InterlockedCompareExchange(&m_cursor, LONG(next), LONG(cursor))) == cursor)
+		{
+			InterlockedExchangeAdd(&m_dropped, LONG(next - cursor));
+		}
+	}
+}
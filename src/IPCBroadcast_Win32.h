@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QString>
+
+///////////////////////////////////////////////////////////////////////////////
+// IPC BROADCAST
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		/*
+		 * Single-publish/multi-subscribe ring of fixed-size slots, located in a shared memory block
+		 *
+		 * The writers never wait for the subscribers: each slot is overwritten as soon as the ring has wrapped around. Every subscriber keeps its own (process-local) read cursor; a subscriber that has been lapped by the writers skips to the oldest message that is still available and the skipped messages are counted as "dropped". A subscriber does not receive the messages that it has sent itself.
+		 * Each subscriber owns an entry in the subscriber table, which has its own wake-up event, so that the writers can wake up all sleeping subscribers at once.
+		 */
+		class IPCBroadcast
+		{
+		public:
+			static const quint32 INFINITE_TIMEOUT = 0xFFFFFFFF;
+			static const quint32 MAX_SUBSCRIBERS = 32;
+
+			static size_t required_size(const quint32 slotCount, const quint32 slotSize);
+
+			IPCBroadcast(void);
+			~IPCBroadcast(void);
+
+			bool create(void *const buffer, const size_t size, const quint32 slotCount, const quint32 slotSize, const QString &wakeupId);
+			bool attach(void *const buffer, const size_t size, const QString &wakeupId);
+
+			quint8 *reserve(quint32 &position);
+			void publish(const quint32 position, const quint32 length);
+
+			bool subscribed(void) const { return (m_subscriber < MAX_SUBSCRIBERS); }
+			bool read(quint8 *const buffer, quint32 &length, const quint32 timeout);
+			quint32 dropped(void) const { return quint32(m_dropped); }
+
+			inline quint32 maxLength(void) const { return m_slotSize - 8U; }
+
+		private:
+			MUTILS_NO_COPY(IPCBroadcast)
+
+			bool open(const QString &wakeupId);
+			void setup(void *const buffer, const quint32 slotCount, const quint32 slotSize);
+			void subscribe(void);
+			void unsubscribe(void);
+			bool tryRead(quint8 *const buffer, quint32 &length);
+			void wake(void);
+
+			quint32 m_slotCount;
+			quint32 m_slotSize;
+			quint32 m_subscriber;
+			void *m_header;
+			quint8 *m_slots;
+			volatile long m_cursor;
+			volatile long m_dropped;
+			QString m_wakeupId;
+			void *volatile m_events[MAX_SUBSCRIBERS];
+		};
+	}
+}
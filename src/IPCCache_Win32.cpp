@@ -0,0 +1,470 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/IPCCache.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Internal.h"
+
+//Qt
+#include <QSharedMemory>
+#include <QReadWriteLock>
+#include <QCryptographicHash>
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		static const size_t  CACHE_HDR_LEN = 40;
+		static const size_t  CACHE_OFFSET = 64;
+		static const quint32 CACHE_WAYS = 8;
+		static const quint32 CACHE_SETS = IPCCache::BUCKET_COUNT / CACHE_WAYS;
+		static const quint32 CACHE_RETRIES = 4096;
+
+		typedef struct
+		{
+			char header[CACHE_HDR_LEN];
+			volatile LONG clock;
+		}
+		cache_header_t;
+
+		/*
+		 * The "sequence" is odd while the bucket is being modified; a bucket with a key length of zero is empty
+		 */
+		typedef struct
+		{
+			volatile LONG sequence;
+			volatile LONG stamp;
+			quint32 hash;
+			quint32 keyLen;
+			quint32 valueLen;
+			quint32 reserved;
+			char key[IPCCache::MAX_KEY_LEN];
+			char value[IPCCache::MAX_VALUE_LEN];
+		}
+		cache_bucket_t;
+
+		static inline size_t CACHE_SEGMENT_SIZE(void)
+		{
+			return CACHE_OFFSET + (sizeof(cache_bucket_t) * IPCCache::BUCKET_COUNT);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UTILITIES
+///////////////////////////////////////////////////////////////////////////////
+
+#define MAKE_ID(APP, VER, SCOPE, ITEM) MUtils::Internal::make_ipc_id("ipccache", (APP), (VER), (SCOPE), (ITEM))
+
+static inline quint32 HASH_KEY(const QByteArray &key)
+{
+	quint32 hash = 0x811C9DC5;
+	for(int i = 0; i < key.size(); i++)
+	{
+		hash = (hash ^ quint8(key.at(i))) * 0x01000193;
+	}
+	return hash;
+}
+
+static inline bool CHECK_KEY(const QByteArray &key)
+{
+	if(key.isEmpty() || (quint32(key.size()) > MUtils::IPCCache::MAX_KEY_LEN))
+	{
+		qWarning("IPC cache key is empty or exceeds the maximum size of %u bytes!", MUtils::IPCCache::MAX_KEY_LEN);
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class IPCCache_Private
+	{
+		friend class IPCCache;
+
+	protected:
+		IPCCache_Private(void) : mutex(NULL), header(NULL), buckets(NULL) {}
+		~IPCCache_Private(void)
+		{
+			if(mutex)
+			{
+				CloseHandle(mutex);
+			}
+		}
+
+		bool lock(void);
+		void unlock(void);
+		Internal::cache_bucket_t *find(const quint32 hash, const QByteArray &key);
+		void write(Internal::cache_bucket_t *const bucket, const quint32 hash, const QByteArray &key, const QByteArray &value);
+		void repair(void);
+
+		QAtomicInt initialized;
+		QScopedPointer<QSharedMemory> sharedmem;
+		HANDLE mutex;
+		Internal::cache_header_t *header;
+		Internal::cache_bucket_t *buckets;
+		QReadWriteLock lock_init;
+	};
+}
+
+/*
+ * If the previous owner of the mutex has terminated while modifying a bucket, that bucket is left "odd" forever, so it has to be repaired
+ */
+bool MUtils::IPCCache_Private::lock(void)
+{
+	const DWORD result = WaitForSingleObject(mutex, INFINITE);
+	if(result == WAIT_ABANDONED)
+	{
+		qWarning("Previous owner of the IPC cache has terminated unexpectedly!");
+		repair();
+		return true;
+	}
+	if(result != WAIT_OBJECT_0)
+	{
+		qWarning("Failed to lock the IPC cache (error: %u)", GetLastError());
+		return false;
+	}
+	return true;
+}
+
+void MUtils::IPCCache_Private::unlock(void)
+{
+	ReleaseMutex(mutex);
+}
+
+void MUtils::IPCCache_Private::repair(void)
+{
+	for(quint32 i = 0; i < IPCCache::BUCKET_COUNT; i++)
+	{
+		if(buckets[i].sequence & 1)
+		{
+			buckets[i].keyLen = 0;
+			InterlockedIncrement(&buckets[i].sequence);
+		}
+	}
+}
+
+/*
+ * Must be called with the mutex held, so the buckets can be accessed without the sequence lock
+ */
+MUtils::Internal::cache_bucket_t *MUtils::IPCCache_Private::find(const quint32 hash, const QByteArray &key)
+{
+	Internal::cache_bucket_t *const set = buckets + ((hash % Internal::CACHE_SETS) * Internal::CACHE_WAYS);
+	for(quint32 way = 0; way < Internal::CACHE_WAYS; way++)
+	{
+		Internal::cache_bucket_t *const bucket = set + way;
+		if((bucket->keyLen == quint32(key.size())) && (bucket->hash == hash) && (memcmp(bucket->key, key.constData(), key.size()) == 0))
+		{
+			return bucket;
+		}
+	}
+	return NULL;
+}
+
+void MUtils::IPCCache_Private::write(Internal::cache_bucket_t *const bucket, const quint32 hash, const QByteArray &key, const QByteArray &value)
+{
+	InterlockedIncrement(&bucket->sequence);
+	bucket->hash = hash;
+	bucket->keyLen = quint32(key.size());
+	bucket->valueLen = quint32(value.size());
+	memcpy(bucket->key, key.constData(), key.size());
+	memcpy(bucket->value, value.constData(), value.size());
+	InterlockedExchange(&bucket->stamp, InterlockedIncrement(&header->clock));
+	InterlockedIncrement(&bucket->sequence);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCCache::IPCCache(const QString &applicationId, const quint32 &appVersionNo, const QString &cacheId)
+:
+	p(new IPCCache_Private()),
+	m_applicationId(applicationId),
+	m_cacheId(cacheId),
+	m_appVersionNo(appVersionNo),
+	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, cacheId, "header").toLatin1(), QCryptographicHash::Sha1).toHex())
+{
+	if(m_headerStr.length() != Internal::CACHE_HDR_LEN)
+	{
+		MUTILS_THROW("Invalid header length has been detected!");
+	}
+}
+
+MUtils::IPCCache::~IPCCache(void)
+{
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		if(p->sharedmem->isAttached())
+		{
+			p->sharedmem->detach();
+		}
+	}
+
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::IPCCache::initialize(void)
+{
+	QWriteLocker writeLock(&p->lock_init);
+
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		return IPCChannel::RET_ALREADY_INITIALIZED;
+	}
+
+	const QString mutexName(MAKE_ID(m_applicationId, m_appVersionNo, m_cacheId, "mutex"));
+	p->mutex = CreateMutexW(NULL, FALSE, MUTILS_WCHR(mutexName));
+	if(!p->mutex)
+	{
+		qWarning("Failed to create mutex \"%s\" (error: %u)", MUTILS_UTF8(mutexName), GetLastError());
+		return IPCChannel::RET_FAILURE;
+	}
+
+	const int segmentSize = int(Internal::CACHE_SEGMENT_SIZE());
+	p->sharedmem.reset(new QSharedMemory(MAKE_ID(m_applicationId, m_appVersionNo, m_cacheId, "sharedmem"), 0));
+
+	if(!p->sharedmem->create(segmentSize))
+	{
+		if(p->sharedmem->error() != QSharedMemory::AlreadyExists)
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(!p->sharedmem->attach())
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(p->sharedmem->size() < segmentSize)
+		{
+			qWarning("Failed to attach to shared memory: Size verification has failed!");
+			return IPCChannel::RET_FAILURE;
+		}
+		char *const ptr = reinterpret_cast<char*>(p->sharedmem->data());
+		if(!ptr)
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(memcmp(ptr, m_headerStr.constData(), Internal::CACHE_HDR_LEN) != 0)
+		{
+			qWarning("Failed to attach to shared memory: Header verification has failed!");
+			return IPCChannel::RET_FAILURE;
+		}
+		p->header = reinterpret_cast<Internal::cache_header_t*>(ptr);
+		p->buckets = reinterpret_cast<Internal::cache_bucket_t*>(ptr + Internal::CACHE_OFFSET);
+		p->initialized.ref();
+		return IPCChannel::RET_SUCCESS_SLAVE;
+	}
+
+	char *const ptr = reinterpret_cast<char*>(p->sharedmem->data());
+	if(!ptr)
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+		return IPCChannel::RET_FAILURE;
+	}
+
+	memset(ptr, 0, size_t(segmentSize));
+	memcpy(ptr, m_headerStr.constData(), Internal::CACHE_HDR_LEN);
+	p->header = reinterpret_cast<Internal::cache_header_t*>(ptr);
+	p->buckets = reinterpret_cast<Internal::cache_bucket_t*>(ptr + Internal::CACHE_OFFSET);
+
+	p->initialized.ref();
+	return IPCChannel::RET_SUCCESS_MASTER;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// LOOKUP
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Sequence lock: the bucket is copied *optimistically* and the copy is discarded, if the sequence was odd or has changed in the meantime. A bucket that stays "odd" for too long is treated as a miss, so a crashed writer can not block the readers.
+ */
+bool MUtils::IPCCache::lookup(const QByteArray &key, QByteArray &value) const
+{
+	QReadLocker readLock(&p->lock_init);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!CHECK_KEY(key))
+	{
+		return false;
+	}
+
+	const quint32 hash = HASH_KEY(key);
+	Internal::cache_bucket_t *const set = p->buckets + ((hash % Internal::CACHE_SETS) * Internal::CACHE_WAYS);
+	char buffer[MAX_VALUE_LEN];
+
+	for(quint32 way = 0; way < Internal::CACHE_WAYS; way++)
+	{
+		Internal::cache_bucket_t *const bucket = set + way;
+		for(quint32 retry = 0; retry < Internal::CACHE_RETRIES; retry++)
+		{
+			const LONG sequence = bucket->sequence;
+			if(sequence & 1)
+			{
+				YieldProcessor();
+				continue;
+			}
+			MemoryBarrier();
+			bool found = false;
+			quint32 length = 0;
+			if((bucket->hash == hash) && (bucket->keyLen == quint32(key.size())) && (memcmp(bucket->key, key.constData(), key.size()) == 0))
+			{
+				length = qMin(bucket->valueLen, MAX_VALUE_LEN);
+				memcpy(buffer, bucket->value, length);
+				found = true;
+			}
+			MemoryBarrier();
+			if(bucket->sequence != sequence)
+			{
+				continue; /*modified in the meantime*/
+			}
+			if(found)
+			{
+				const LONG now = p->header->clock;
+				if(bucket->stamp != now)
+				{
+					bucket->stamp = now; /*refresh only when stale, so that hot entries are not written on every hit*/
+				}
+				value = QByteArray(buffer, int(length));
+				return true;
+			}
+			break;
+		}
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INSERT & REMOVE
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The victim is an existing entry with the same key, an empty bucket, or the least-recently used entry of the set (in this order). Stamps are compared relative to the current clock, so wrap-around does no harm.
+ * The clock only advances on insert, so the LRU order is approximate: all entries that were hit since the last insert have the same age.
+ */
+bool MUtils::IPCCache::insert(const QByteArray &key, const QByteArray &value)
+{
+	QReadLocker readLock(&p->lock_init);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!CHECK_KEY(key))
+	{
+		return false;
+	}
+
+	if(quint32(value.size()) > MAX_VALUE_LEN)
+	{
+		qWarning("IPC cache value exceeds the maximum size of %u bytes!", MAX_VALUE_LEN);
+		return false;
+	}
+
+	if(!p->lock())
+	{
+		return false;
+	}
+
+	const quint32 hash = HASH_KEY(key);
+	Internal::cache_bucket_t *victim = p->find(hash, key);
+	if(!victim)
+	{
+		Internal::cache_bucket_t *const set = p->buckets + ((hash % Internal::CACHE_SETS) * Internal::CACHE_WAYS);
+		const LONG now = p->header->clock;
+		for(quint32 way = 0; way < Internal::CACHE_WAYS; way++)
+		{
+			Internal::cache_bucket_t *const bucket = set + way;
+			if(bucket->keyLen == 0)
+			{
+				victim = bucket;
+				break;
+			}
+			if((!victim) || (LONG(quint32(bucket->stamp) - quint32(now)) < LONG(quint32(victim->stamp) - quint32(now))))
+			{
+				victim = bucket;
+			}
+		}
+	}
+
+	p->write(victim, hash, key, value);
+	p->unlock();
+	return true;
+}
+
+bool MUtils::IPCCache::remove(const QByteArray &key)
+{
+	QReadLocker readLock(&p->lock_init);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if((!CHECK_KEY(key)) || (!p->lock()))
+	{
+		return false;
+	}
+
+	Internal::cache_bucket_t *const bucket = p->find(HASH_KEY(key), key);
+	if(bucket)
+	{
+		InterlockedIncrement(&bucket->sequence);
+		bucket->keyLen = 0;
+		InterlockedIncrement(&bucket->sequence);
+	}
+
+	p->unlock();
+	return (bucket != NULL);
+}
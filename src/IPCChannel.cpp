@@ -21,19 +21,31 @@
 
 //MUtils
 #include <MUtils/IPCChannel.h>
+#include <MUtils/IPCNotifier.h>
+#include <MUtils/IPCPayload.h>
 #include <MUtils/Exception.h>
 
 //Internal
+#include "Internal.h"
+#include "IPCRing_Win32.h"
+#include "IPCBroadcast_Win32.h"
+#include "IPCPipe_Win32.h"
+#include "IPCSemaphore_Win32.h"
 #include "3rd_party/adler32/include/adler32.h"
 
 //Qt includes
-#include <QRegExp>
 #include <QSharedMemory>
-#include <QSystemSemaphore>
 #include <QMutex>
 #include <QWriteLocker>
 #include <QCryptographicHash>
 #include <QStringList>
+#include <QVector>
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+#include <QWinEventNotifier>
+#else
+#include <private/qwineventnotifier_p.h>
+#endif
+
 //CRT
 #include <cassert>
 
@@ -71,6 +83,8 @@ namespace MUtils
 	{
 		static const size_t HDR_LEN = 40;
 		static const size_t IPC_SLOTS = 128;
+		static const size_t IPC_SLOTS_PRIORITY = 16;
+		static const size_t IPC_LANES = 3;
 
 		typedef struct
 		{
@@ -117,6 +131,94 @@ namespace MUtils
 			ipc_msg_t    data[IPC_SLOTS];
 		}
 		ipc_t;
+
+		/*
+		 * The priority lanes are appended *behind* the original ipc_t, which is left untouched, so the normal lane stays compatible with previous versions. Each priority lane has its own range of slots, its own read/write position and its own "free slots" semaphore; it also counts its pending messages, so the reader knows which lane to drain first.
+		 */
+		typedef struct
+		{
+			quint64 counter;
+			quint32 pos_wr;
+			quint32 pos_rd;
+			quint32 pending;
+		}
+		ipc_lane_status_data_t;
+
+		typedef struct
+		{
+			ipc_lane_status_data_t payload;
+			quint32                checksum;
+		}
+		ipc_lane_status_t;
+
+		typedef struct
+		{
+			ipc_lane_status_t status;
+			ipc_msg_t         data[IPC_SLOTS_PRIORITY];
+		}
+		ipc_lane_t;
+
+		typedef struct
+		{
+			ipc_t      normal;
+			ipc_lane_t priority[IPC_LANES - 1];
+		}
+		ipc_lanes_t;
+
+		static const quint32 RING_CELLS = 16384;
+		static const quint32 RING_CELL_SIZE = 64;
+		static const quint32 RING_BATCH_MAX = 1024;
+		static const size_t RING_OFFSET = 64;
+
+		typedef struct
+		{
+			quint32 checksum;
+			quint32 command_id;
+			quint32 flags;
+			quint32 param_count;
+			quint64 timestamp;
+		}
+		ipc_frame_t;
+
+		static const quint32 FRAME_PAYLOAD = 0xFFFFFFFF;
+
+		typedef struct
+		{
+			QList<QByteArray> values;
+			QByteArray payload;
+			bool typed;
+			quint32 length;
+		}
+		frame_body_t;
+
+		static const int STASH_MAX = 1024;
+
+		typedef struct
+		{
+			QByteArray data;
+			void *handle;
+		}
+		stash_frame_t;
+
+		typedef struct
+		{
+			QMutex mutex;
+			QList<stash_frame_t> frames;
+		}
+		frame_stash_t;
+
+		static inline size_t RING_SEGMENT_SIZE(void)
+		{
+			return RING_OFFSET + IPCRing::required_size(RING_CELLS, RING_CELL_SIZE);
+		}
+
+		static const quint32 BCAST_SLOTS = 1024;
+		static const quint32 BCAST_SLOT_SIZE = 1024;
+
+		static inline size_t BCAST_SEGMENT_SIZE(void)
+		{
+			return RING_OFFSET + IPCBroadcast::required_size(BCAST_SLOTS, BCAST_SLOT_SIZE);
+		}
 	}
 }
 
@@ -124,21 +226,18 @@ namespace MUtils
 // UTILITIES
 ///////////////////////////////////////////////////////////////////////////////
 
-static QScopedPointer<QRegExp> g_escape_regexp;
-static QMutex g_escape_lock;
+#define MAKE_ID(APP, VER, SCOPE, ITEM) MUtils::Internal::make_ipc_id("ipc", (APP), (VER), (SCOPE), (ITEM))
 
-#define ESCAPE(STR) (QString((STR)).replace(*g_escape_regexp, QLatin1String("_")).toLower())
-
-static QString MAKE_ID(const QString &applicationId, const unsigned int &appVersionNo, const QString &channelId, const QString &itemId)
+static QString HEADER_ID(const int &mode)
 {
-	QMutexLocker locker(&g_escape_lock);
+	static const char *const HEADER_NAMES[] = { "header", "header_ring", "header_broadcast", "header_pipe" };
 
-	if(g_escape_regexp.isNull())
+	if((mode < MUtils::IPCChannel::MODE_SEMAPHORE) || (mode > MUtils::IPCChannel::MODE_PIPE))
 	{
-		g_escape_regexp.reset(new QRegExp(QLatin1String("[^A-Za-z0-9_\\-]")));
+		MUTILS_THROW("Invalid IPC mode has been specified!");
 	}
 
-	return QString("com.muldersoft.mutilities.ipc.%1.r%2.%3.%4").arg(ESCAPE(applicationId), QString::number(appVersionNo, 16).toUpper(), ESCAPE(channelId), ESCAPE(itemId));
+	return QLatin1String(HEADER_NAMES[mode]);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -150,319 +249,1568 @@ namespace MUtils
 	class IPCChannel_Private
 	{
 		friend class IPCChannel;
+		friend class IPCNotifier;
 
 	protected:
+		bool semaphoreSend(const QList<IPCChannel::ipc_message_t> &messages, const size_t lane);
+		bool semaphoreRead(QList<IPCChannel::ipc_message_t> &messages, const quint32 maxCount, const quint32 timeout);
+
 		QAtomicInt initialized;
 		QScopedPointer<QSharedMemory> sharedmem;
-		QScopedPointer<QSystemSemaphore> semaphore_rd;
-		QScopedPointer<QSystemSemaphore> semaphore_wr;
+		QScopedPointer<Internal::IPCSemaphore> semaphore_rd;
+		QScopedPointer<Internal::IPCSemaphore> semaphore_wr[Internal::IPC_LANES];
+		QScopedPointer<Internal::IPCRing> ring;
+		QScopedPointer<Internal::IPCBroadcast> broadcast;
+		QScopedPointer<Internal::IPCPipe> pipe;
 		QReadWriteLock lock;
+		size_t lanes;
+		QList<IPCNotifier*> notifiers;
+		Internal::frame_stash_t stash;
 	};
 }
 
+/*
+ * Protects the registered notifiers *and* their back-pointer to the channel, so that a notifier can outlive its channel
+ */
+static QMutex g_notifier_lock;
+
 ///////////////////////////////////////////////////////////////////////////////
-// CONSTRUCTOR & DESTRUCTOR
+// SEMAPHORE MODE
 ///////////////////////////////////////////////////////////////////////////////
 
-MUtils::IPCChannel::IPCChannel(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId)
-:
-	p(new IPCChannel_Private()),
-	m_applicationId(applicationId),
-	m_channelId(channelId),
-	m_appVersionNo(appVersionNo),
-	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, channelId, "header").toLatin1(), QCryptographicHash::Sha1).toHex())
+/*
+ * In "semaphore" mode, each message is copied into a fixed-size slot of its lane, while the shared memory is locked. The "read" semaphore counts the messages in all lanes, whereas the "write" semaphore of each lane counts its free slots.
+ */
+
+static void sem_encode(MUtils::Internal::ipc_msg_t &ipc_msg, const quint32 &command, const quint32 &flags, const QStringList &params)
 {
-	if(m_headerStr.length() != Internal::HDR_LEN)
+	memset(&ipc_msg, 0, sizeof(MUtils::Internal::ipc_msg_t));
+	ipc_msg.payload.command_id = command;
+	ipc_msg.payload.flags = flags;
+	if(!params.isEmpty())
 	{
-		MUTILS_THROW("Invalid header length has been detected!");
+		const quint32 param_count = qMin(MUtils::IPCChannel::MAX_PARAM_CNT, (quint32)params.count());
+		for(quint32 i = 0; i < param_count; i++)
+		{
+			strncpy_s(ipc_msg.payload.params.values[i], MUtils::IPCChannel::MAX_PARAM_LEN, MUTILS_UTF8(params[i].trimmed()), _TRUNCATE);
+		}
+		ipc_msg.payload.params.count = param_count;
 	}
 }
 
-MUtils::IPCChannel::~IPCChannel(void)
+static bool sem_decode(const MUtils::Internal::ipc_msg_t &ipc_msg, const quint64 &counter, quint32 &command, quint32 &flags, QStringList &params)
 {
-	if(MUTILS_BOOLIFY(p->initialized))
+	if(VERIFY_CHECKSUM(ipc_msg) || (ipc_msg.payload.timestamp < counter))
 	{
-		if(p->sharedmem->isAttached())
+		command = ipc_msg.payload.command_id;
+		flags = ipc_msg.payload.flags;
+		const quint32 param_count = qMin(ipc_msg.payload.params.count, MUtils::IPCChannel::MAX_PARAM_CNT);
+		char temp[MUtils::IPCChannel::MAX_PARAM_LEN];
+		for(quint32 i = 0; i < param_count; i++)
 		{
-			p->sharedmem->detach();
+			strncpy_s(temp, MUtils::IPCChannel::MAX_PARAM_LEN, ipc_msg.payload.params.values[i], _TRUNCATE);
+			params.append(QString::fromUtf8(temp));
 		}
+		return true;
 	}
 
-	delete p;
+	qWarning("Malformed or corrupted IPC message, will be ignored!");
+	return false;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// INITIALIZATION
-///////////////////////////////////////////////////////////////////////////////
+static inline void lane_count(MUtils::Internal::ipc_status_data_t&, const bool)
+{
+	/*the normal lane keeps the original layout, which does not count the pending messages*/
+}
 
-int MUtils::IPCChannel::initialize(void)
+static inline void lane_count(MUtils::Internal::ipc_lane_status_data_t &status, const bool increment)
 {
-	QWriteLocker writeLock(&p->lock);
-	
-	if(MUTILS_BOOLIFY(p->initialized))
+	status.pending = increment ? (status.pending + 1U) : (status.pending - 1U);
+}
+
+template<class T>
+static bool lane_write(T &status, MUtils::Internal::ipc_msg_t *const slots, const quint32 slotCount, MUtils::Internal::ipc_msg_t &ipc_msg)
+{
+	if(!VERIFY_CHECKSUM(status))
 	{
-		return RET_ALREADY_INITIALIZED;
+		qWarning("Corrupted IPC status detected -> skipping!");
+		return false;
 	}
 
-	p->sharedmem.   reset(new QSharedMemory   (MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "sharedmem"), 0));
-	p->semaphore_rd.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_rd"), 0));
-	p->semaphore_wr.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_wr"), 0));
+	ipc_msg.payload.timestamp = status.payload.counter++;
+	UPDATE_CHECKSUM(ipc_msg);
+
+	memcpy(&slots[status.payload.pos_wr], &ipc_msg, sizeof(MUtils::Internal::ipc_msg_t));
+	status.payload.pos_wr = (status.payload.pos_wr + 1U) % slotCount;
+	lane_count(status.payload, true);
+	UPDATE_CHECKSUM(status);
+	return true;
+}
 
-	if(p->semaphore_rd->error() != QSystemSemaphore::NoError)
+template<class T>
+static bool lane_read(T &status, const MUtils::Internal::ipc_msg_t *const slots, const quint32 slotCount, MUtils::Internal::ipc_msg_t &ipc_msg, quint64 &counter)
+{
+	if(!VERIFY_CHECKSUM(status))
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		qWarning("Corrupted IPC status detected -> skipping!");
+		return false;
 	}
 
-	if(p->semaphore_wr->error() != QSystemSemaphore::NoError)
+	memcpy(&ipc_msg, &slots[status.payload.pos_rd], sizeof(MUtils::Internal::ipc_msg_t));
+	status.payload.pos_rd = (status.payload.pos_rd + 1U) % slotCount;
+	lane_count(status.payload, false);
+	UPDATE_CHECKSUM(status);
+
+	counter = status.payload.counter;
+	return true;
+}
+
+static bool sem_write(MUtils::Internal::ipc_lanes_t *const ptr, const size_t lane, MUtils::Internal::ipc_msg_t &ipc_msg)
+{
+	if(lane > 0)
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		MUtils::Internal::ipc_lane_t &priority = ptr->priority[lane - 1];
+		return lane_write(priority.status, priority.data, MUtils::Internal::IPC_SLOTS_PRIORITY, ipc_msg);
 	}
-	
-	if(!p->sharedmem->create(sizeof(Internal::ipc_t)))
+	return lane_write(ptr->normal.status, ptr->normal.data, MUtils::Internal::IPC_SLOTS, ipc_msg);
+}
+
+/*
+ * The highest priority lane that has a pending message is drained first; if none has, the message *must* be in the normal lane
+ */
+static bool sem_read(MUtils::Internal::ipc_lanes_t *const ptr, const size_t lanes, size_t &lane, MUtils::Internal::ipc_msg_t &ipc_msg, quint64 &counter)
+{
+	for(lane = lanes - 1; lane > 0; lane--)
 	{
-		if(p->sharedmem->error() == QSharedMemory::AlreadyExists)
+		MUtils::Internal::ipc_lane_t &priority = ptr->priority[lane - 1];
+		if(VERIFY_CHECKSUM(priority.status) && (priority.status.payload.pending > 0))
 		{
-			if(!p->sharedmem->attach())
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			if(p->sharedmem->error() != QSharedMemory::NoError)
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			if(p->sharedmem->size() < sizeof(Internal::ipc_t))
-			{
-				qWarning("Failed to attach to shared memory: Size verification has failed!");
-				return RET_FAILURE;
-			}
-			if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+			return lane_read(priority.status, priority.data, MUtils::Internal::IPC_SLOTS_PRIORITY, ipc_msg, counter);
+		}
+	}
+	return lane_read(ptr->normal.status, ptr->normal.data, MUtils::Internal::IPC_SLOTS, ipc_msg, counter);
+}
+
+static QString SEMAPHORE_ID(const size_t lane)
+{
+	return (lane > 0) ? QString("semaph_wr%1").arg(lane) : QString("semaph_wr");
+}
+
+/*
+ * Take as many free slots as are available right now (but at least one), then write that many messages while the shared memory is locked only *once*
+ */
+bool MUtils::IPCChannel_Private::semaphoreSend(const QList<IPCChannel::ipc_message_t> &messages, const size_t lane)
+{
+	int offset = 0;
+	while(offset < messages.count())
+	{
+		if(!semaphore_wr[lane]->acquire(Internal::IPCSemaphore::INFINITE_TIMEOUT))
+		{
+			qWarning("Failed to acquire system semaphore!");
+			return false;
+		}
+
+		const quint32 count = 1U + semaphore_wr[lane]->tryAcquire(quint32(messages.count() - offset) - 1U);
+		if(!sharedmem->lock())
+		{
+			const QString errorMessage = sharedmem->errorString();
+			qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
+			semaphore_wr[lane]->release(count);
+			return false;
+		}
+
+		quint32 written = 0;
+		if(Internal::ipc_lanes_t *const ptr = reinterpret_cast<Internal::ipc_lanes_t*>(sharedmem->data()))
+		{
+			Internal::ipc_msg_t ipc_msg;
+			while(written < count)
 			{
-				if(memcmp(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN) != 0)
+				const IPCChannel::ipc_message_t &message = messages[offset + int(written)];
+				sem_encode(ipc_msg, message.command, message.flags, message.params);
+				if(!sem_write(ptr, lane, ipc_msg))
 				{
-					qWarning("Failed to attach to shared memory: Header verification has failed!");
-					return RET_FAILURE;
+					break;
 				}
+				written++;
 			}
-			else
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			p->initialized.ref();
-			return RET_SUCCESS_SLAVE;
 		}
 		else
 		{
-			const QString errorMessage = p->sharedmem->errorString();
-			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
-			return RET_FAILURE;
+			qWarning("Shared memory pointer is NULL -> unable to write data!");
 		}
-	}
-	
-	if(p->sharedmem->error() != QSharedMemory::NoError)
-	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
-	}
 
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
-	{
-		memset(ptr, 0, sizeof(Internal::ipc_t));
-		memcpy(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN);
-		UPDATE_CHECKSUM(ptr->status);
-	}
-	else
-	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
-	}
+		if(!sharedmem->unlock())
+		{
+			const QString errorMessage = sharedmem->errorString();
+			qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
+		}
 
-	if(!p->semaphore_wr->release(Internal::IPC_SLOTS))
-	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		if(!semaphore_rd->release(written))
+		{
+			qWarning("Failed to release system semaphore!");
+		}
+
+		if(written < count)
+		{
+			semaphore_wr[lane]->release(count - written); /*give back the unused slots*/
+			return false;
+		}
+
+		offset += int(count);
 	}
-	
-	//qDebug("IPC KEY #1: %s", MUTILS_UTF8(p->sharedmem->key()));
-	//qDebug("IPC KEY #2: %s", MUTILS_UTF8(p->semaphore_rd->key()));
-	//qDebug("IPC KEY #3: %s", MUTILS_UTF8(p->semaphore_wr->key()));
 
-	p->initialized.ref();
-	return RET_SUCCESS_MASTER;
+	return true;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// SEND MESSAGE
-///////////////////////////////////////////////////////////////////////////////
-
-bool MUtils::IPCChannel::send(const quint32 &command, const quint32 &flags, const QStringList &params)
+/*
+ * Take as many pending messages as are available right now (up to "maxCount", but at least one), then read them while the shared memory is locked only *once*
+ */
+bool MUtils::IPCChannel_Private::semaphoreRead(QList<IPCChannel::ipc_message_t> &messages, const quint32 maxCount, const quint32 timeout)
 {
-	bool success = false;
-	QReadLocker readLock(&p->lock);
-
-	if(!p->initialized)
-	{
-		MUTILS_THROW("Shared memory for IPC not initialized yet.");
-	}
-
-	if(!p->semaphore_wr->acquire())
+	if(!semaphore_rd->acquire(timeout))
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to acquire system semaphore: %s", MUTILS_UTF8(errorMessage));
+		if(timeout == Internal::IPCSemaphore::INFINITE_TIMEOUT)
+		{
+			qWarning("Failed to acquire system semaphore!");
+		}
 		return false;
 	}
 
-	if(!p->sharedmem->lock())
+	const quint32 count = 1U + semaphore_rd->tryAcquire(maxCount - 1U);
+	if(!sharedmem->lock())
 	{
-		const QString errorMessage = p->sharedmem->errorString();
+		const QString errorMessage = sharedmem->errorString();
 		qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
+		semaphore_rd->release(count);
 		return false;
 	}
 
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+	quint32 freed[Internal::IPC_LANES] = { 0U };
+	if(Internal::ipc_lanes_t *const ptr = reinterpret_cast<Internal::ipc_lanes_t*>(sharedmem->data()))
 	{
-		if(VERIFY_CHECKSUM(ptr->status))
+		Internal::ipc_msg_t ipc_msg;
+		for(quint32 i = 0; i < count; i++)
 		{
-			Internal::ipc_msg_t ipc_msg;
-			memset(&ipc_msg, 0, sizeof(Internal::ipc_msg_t));
-
-			ipc_msg.payload.command_id = command;
-			ipc_msg.payload.flags = flags;
-			if(!params.isEmpty())
+			size_t lane = 0;
+			quint64 counter = 0;
+			if(sem_read(ptr, lanes, lane, ipc_msg, counter))
 			{
-				const quint32 param_count = qMin(MAX_PARAM_CNT, (quint32)params.count());
-				for(quint32 i = 0; i < param_count; i++)
+				IPCChannel::ipc_message_t message;
+				if(sem_decode(ipc_msg, counter, message.command, message.flags, message.params))
 				{
-					strncpy_s(ipc_msg.payload.params.values[i], MAX_PARAM_LEN, MUTILS_UTF8(params[i].trimmed()), _TRUNCATE);
+					messages.append(message);
 				}
-				ipc_msg.payload.params.count = param_count;
 			}
-			ipc_msg.payload.timestamp = ptr->status.payload.counter++;
-			UPDATE_CHECKSUM(ipc_msg);
-
-			memcpy(&ptr->data[ptr->status.payload.pos_wr], &ipc_msg, sizeof(Internal::ipc_msg_t));
-			ptr->status.payload.pos_wr = (ptr->status.payload.pos_wr + 1) % Internal::IPC_SLOTS;
-			UPDATE_CHECKSUM(ptr->status);
-
-			success = true;
-		}
-		else
-		{
-			qWarning("Corrupted IPC status detected -> skipping!");
+			freed[lane]++;
 		}
 	}
 	else
 	{
-		qWarning("Shared memory pointer is NULL -> unable to write data!");
+		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		freed[0] = count;
 	}
 
-	if(!p->sharedmem->unlock())
+	if(!sharedmem->unlock())
 	{
-		const QString errorMessage = p->sharedmem->errorString();
+		const QString errorMessage = sharedmem->errorString();
 		qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
 	}
 
-	if(!p->semaphore_rd->release())
+	for(size_t lane = 0; lane < Internal::IPC_LANES; lane++)
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		if(!semaphore_wr[lane]->release(freed[lane]))
+		{
+			qWarning("Failed to release system semaphore!");
+		}
 	}
 
-	return success;
+	return (!messages.isEmpty());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// READ MESSAGE
+// RING MODE
 ///////////////////////////////////////////////////////////////////////////////
 
-bool MUtils::IPCChannel::read(quint32 &command, quint32 &flags, QStringList &params)
+/*
+ * In "ring" mode, each message is stored as a variable-length frame: the ipc_frame_t header is followed by the parameters, each one prefixed with its length. Frames are written directly into the space that was reserved in the lock-free ring and parsed directly from the shared memory, so no locks are taken and the kernel is entered only to wake up a sleeping peer.
+ */
+
+static quint32 frame_checksum(const quint8 *const data, const quint32 length)
 {
-	bool success = false;
-	QReadLocker readLock(&p->lock);
-	command = 0;
-	params.clear();
+	return MUtils::Internal::adler32(MUtils::Internal::ADLER_SEED, data + sizeof(quint32), length - quint32(sizeof(quint32)));
+}
 
-	if(!p->initialized)
+static bool frame_encode(const QStringList &params, MUtils::Internal::frame_body_t &body, const quint32 maxLength)
+{
+	quint64 total = sizeof(MUtils::Internal::ipc_frame_t);
+	for(QStringList::ConstIterator iter = params.constBegin(); iter != params.constEnd(); iter++)
 	{
-		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+		body.values.append(iter->trimmed().toUtf8());
+		total += sizeof(quint32) + quint64(body.values.last().size());
 	}
 
-	Internal::ipc_msg_t ipc_msg;
-	memset(&ipc_msg, 0, sizeof(Internal::ipc_msg_t));
-
-	if(!p->semaphore_rd->acquire())
+	if(total > maxLength)
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to acquire system semaphore: %s", MUTILS_UTF8(errorMessage));
+		qWarning("IPC message exceeds the maximum size of %u bytes!", maxLength);
 		return false;
 	}
 
-	if(!p->sharedmem->lock())
+	body.typed = false;
+	body.length = quint32(total);
+	return true;
+}
+
+/*
+ * A typed payload is stored as-is, right after the frame header; it is marked by the special FRAME_PAYLOAD parameter count
+ */
+static bool frame_encode(const MUtils::IPCPayload &payload, MUtils::Internal::frame_body_t &body, const quint32 maxLength)
+{
+	const quint64 total = sizeof(MUtils::Internal::ipc_frame_t) + quint64(payload.data().size());
+	if(total > maxLength)
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
+		qWarning("IPC message exceeds the maximum size of %u bytes!", maxLength);
 		return false;
 	}
 
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+	body.payload = payload.data();
+	body.typed = true;
+	body.length = quint32(total);
+	return true;
+}
+
+static void frame_write(quint8 *const data, const MUtils::Internal::frame_body_t &body, const quint32 &command, const quint32 &flags, const quint64 &timestamp)
+{
+	MUtils::Internal::ipc_frame_t *const frame = reinterpret_cast<MUtils::Internal::ipc_frame_t*>(data);
+	frame->command_id = command;
+	frame->flags = flags;
+	frame->param_count = body.typed ? MUtils::Internal::FRAME_PAYLOAD : quint32(body.values.count());
+	frame->timestamp = timestamp;
+
+	quint8 *ptr = data + sizeof(MUtils::Internal::ipc_frame_t);
+	if(body.typed)
 	{
-		if(VERIFY_CHECKSUM(ptr->status))
+		memcpy(ptr, body.payload.constData(), size_t(body.payload.size()));
+	}
+	else
+	{
+		for(QList<QByteArray>::ConstIterator iter = body.values.constBegin(); iter != body.values.constEnd(); iter++)
 		{
-			memcpy(&ipc_msg, &ptr->data[ptr->status.payload.pos_rd], sizeof(Internal::ipc_msg_t));
-			ptr->status.payload.pos_rd = (ptr->status.payload.pos_rd + 1) % Internal::IPC_SLOTS;
-			UPDATE_CHECKSUM(ptr->status);
+			const quint32 len = quint32(iter->size());
+			memcpy(ptr, &len, sizeof(quint32));
+			memcpy(ptr + sizeof(quint32), iter->constData(), len);
+			ptr += sizeof(quint32) + len;
+		}
+	}
 
-			if(VERIFY_CHECKSUM(ipc_msg) || (ipc_msg.payload.timestamp < ptr->status.payload.counter))
-			{
-				command = ipc_msg.payload.command_id;
-				flags = ipc_msg.payload.flags;
-				const quint32 param_count = qMin(ipc_msg.payload.params.count, MAX_PARAM_CNT);
-				char temp[MAX_PARAM_LEN];
-				for(quint32 i = 0; i < param_count; i++)
-				{
-					strncpy_s(temp, MAX_PARAM_LEN, ipc_msg.payload.params.values[i], _TRUNCATE);
-					params.append(QString::fromUtf8(temp));
-				}
-				success = true;
-			}
-			else
-			{
-				qWarning("Malformed or corrupted IPC message, will be ignored!");
-			}
+	frame->checksum = frame_checksum(data, body.length);
+}
+
+static bool frame_verify(const quint8 *const data, const quint32 length)
+{
+	if(length < sizeof(MUtils::Internal::ipc_frame_t))
+	{
+		qWarning("Malformed IPC message, will be ignored!");
+		return false;
+	}
+
+	const MUtils::Internal::ipc_frame_t *const frame = reinterpret_cast<const MUtils::Internal::ipc_frame_t*>(data);
+	if(frame->checksum != frame_checksum(data, length))
+	{
+		qWarning("Corrupted IPC message, will be ignored!");
+		return false;
+	}
+
+	if(frame->param_count == MUtils::Internal::FRAME_PAYLOAD)
+	{
+		return true;
+	}
+
+	quint32 remaining = length - quint32(sizeof(MUtils::Internal::ipc_frame_t));
+	const quint8 *ptr = data + sizeof(MUtils::Internal::ipc_frame_t);
+	for(quint32 i = 0; i < frame->param_count; i++)
+	{
+		if(remaining < sizeof(quint32))
+		{
+			qWarning("Truncated IPC message, will be ignored!");
+			return false;
 		}
-		else
+		quint32 len;
+		memcpy(&len, ptr, sizeof(quint32));
+		remaining -= quint32(sizeof(quint32));
+		if(remaining < len)
 		{
-			qWarning("Corrupted IPC status detected -> skipping!");
+			qWarning("Truncated IPC message, will be ignored!");
+			return false;
 		}
+		remaining -= len;
+		ptr += sizeof(quint32) + len;
 	}
-	else
+
+	return true;
+}
+
+/*
+ * Exactly one of "params" and "payload" must be non-NULL; a frame of the "wrong" kind must have been put aside with frame_stash() before
+ */
+static bool frame_read(const quint8 *const data, const quint32 length, quint32 &command, quint32 &flags, QStringList *const params, MUtils::IPCPayload *const payload)
+{
+	if(!frame_verify(data, length))
 	{
-		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		return false;
 	}
 
-	if(!p->sharedmem->unlock())
+	const MUtils::Internal::ipc_frame_t *const frame = reinterpret_cast<const MUtils::Internal::ipc_frame_t*>(data);
+	const quint8 *ptr = data + sizeof(MUtils::Internal::ipc_frame_t);
+	if((frame->param_count == MUtils::Internal::FRAME_PAYLOAD) != (payload != NULL))
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
+		qWarning(payload ? "Untyped IPC message received, but a typed payload was expected!" : "Typed IPC message received, but string parameters were expected!");
+		return false;
 	}
 
-	if(!p->semaphore_wr->release())
+	if(payload)
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		*payload = MUtils::IPCPayload(QByteArray(reinterpret_cast<const char*>(ptr), int(length - quint32(sizeof(MUtils::Internal::ipc_frame_t)))));
+	}
+	else
+	{
+		for(quint32 i = 0; i < frame->param_count; i++)
+		{
+			quint32 len;
+			memcpy(&len, ptr, sizeof(quint32));
+			params->append(QString::fromUtf8(reinterpret_cast<const char*>(ptr + sizeof(quint32)), int(len)));
+			ptr += sizeof(quint32) + len;
+		}
+	}
+
+	command = frame->command_id;
+	flags = frame->flags;
+	return true;
+}
+
+/*
+ * A frame of the "wrong" kind (typed vs. untyped) is *not* dropped, but put aside, so that the next read of the matching kind will return it. Returns false, if the frame is of the expected kind. The stash takes ownership of the handle, if any.
+ */
+static bool frame_stash(MUtils::Internal::frame_stash_t *const stash, const quint8 *const data, const quint32 length, const bool typed, void *const handle)
+{
+	if((length < sizeof(MUtils::Internal::ipc_frame_t)) || ((reinterpret_cast<const MUtils::Internal::ipc_frame_t*>(data)->param_count == MUtils::Internal::FRAME_PAYLOAD) == typed))
+	{
+		return false;
+	}
+
+	if(!frame_verify(data, length))
+	{
+		MUtils::Internal::IPCPipe::closeHandle(handle);
+		return true;
+	}
+
+	MUtils::Internal::stash_frame_t frame;
+	frame.data = QByteArray(reinterpret_cast<const char*>(data), int(length));
+	frame.handle = handle;
+
+	QMutexLocker locker(&stash->mutex);
+	if(stash->frames.count() >= MUtils::Internal::STASH_MAX)
+	{
+		qWarning("Too many IPC messages of the other kind are pending, discarding the oldest one!");
+		MUtils::Internal::IPCPipe::closeHandle(stash->frames.takeFirst().handle);
+	}
+	stash->frames.append(frame);
+	return true;
+}
+
+static bool stash_read(MUtils::Internal::frame_stash_t *const stash, quint32 &command, quint32 &flags, QStringList *const params, MUtils::IPCPayload *const payload, void **const handle)
+{
+	QMutexLocker locker(&stash->mutex);
+	for(QList<MUtils::Internal::stash_frame_t>::Iterator iter = stash->frames.begin(); iter != stash->frames.end(); iter++)
+	{
+		if((reinterpret_cast<const MUtils::Internal::ipc_frame_t*>(iter->data.constData())->param_count == MUtils::Internal::FRAME_PAYLOAD) == (payload != NULL))
+		{
+			const MUtils::Internal::stash_frame_t frame = *iter;
+			stash->frames.erase(iter);
+			locker.unlock();
+			if(!frame_read(reinterpret_cast<const quint8*>(frame.data.constData()), quint32(frame.data.size()), command, flags, params, payload))
+			{
+				MUtils::Internal::IPCPipe::closeHandle(frame.handle);
+				return false;
+			}
+			if(handle)
+			{
+				*handle = frame.handle;
+			}
+			else
+			{
+				MUtils::Internal::IPCPipe::closeHandle(frame.handle); /*nobody asked for it*/
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+template<class T>
+static bool ring_send(MUtils::Internal::IPCRing *const ring, const quint32 &command, const quint32 &flags, const T &source, const quint32 &timeout)
+{
+	MUtils::Internal::frame_body_t body;
+	if(!frame_encode(source, body, ring->maxLength()))
+	{
+		return false;
+	}
+
+	MUtils::Internal::IPCRing::ticket_t ticket;
+	if(!ring->reserve(ticket, body.length, timeout))
+	{
+		if(timeout == MUtils::Internal::IPCRing::INFINITE_TIMEOUT)
+		{
+			qWarning("Failed to reserve space in the IPC ring buffer!");
+		}
+		return false;
+	}
+
+	frame_write(ticket.data, body, command, flags, ticket.position);
+	ring->publish(ticket);
+	return true;
+}
+
+static bool ring_read(MUtils::Internal::IPCRing *const ring, MUtils::Internal::frame_stash_t *const stash, quint32 &command, quint32 &flags, QStringList *const params, MUtils::IPCPayload *const payload, const quint32 &timeout)
+{
+	if(stash_read(stash, command, flags, params, payload, NULL))
+	{
+		return true;
+	}
+
+	forever
+	{
+		MUtils::Internal::IPCRing::ticket_t ticket;
+		if(!ring->acquire(ticket, timeout))
+		{
+			if(timeout == MUtils::Internal::IPCRing::INFINITE_TIMEOUT)
+			{
+				qWarning("Failed to acquire a message from the IPC ring buffer!");
+			}
+			return false;
+		}
+
+		if(frame_stash(stash, ticket.data, ticket.length, (payload != NULL), NULL))
+		{
+			ring->release(ticket);
+			continue;
+		}
+
+		const bool success = frame_read(ticket.data, ticket.length, command, flags, params, payload);
+		ring->release(ticket);
+		return success;
+	}
+}
+
+/*
+ * Batches are split into chunks that fit into the ring; all frames of a chunk are written into a single reservation and become visible to the readers at once. All frames are encoded up front, so nothing is published unless the *whole* batch is valid.
+ */
+static bool ring_send_batch(MUtils::Internal::IPCRing *const ring, const QList<MUtils::IPCChannel::ipc_message_t> &messages)
+{
+	QList<MUtils::Internal::frame_body_t> bodies;
+	for(QList<MUtils::IPCChannel::ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); iter++)
+	{
+		MUtils::Internal::frame_body_t current;
+		if(!frame_encode(iter->params, current, ring->maxLength()))
+		{
+			return false;
+		}
+		bodies.append(current);
+	}
+
+	int offset = 0;
+	while(offset < bodies.count())
+	{
+		QVector<quint32> lengths;
+		quint32 span = 0;
+		while((offset + lengths.count() < bodies.count()) && (quint32(lengths.count()) < MUtils::Internal::RING_BATCH_MAX))
+		{
+			const quint32 length = bodies[offset + lengths.count()].length;
+			if(span + ring->cellAlign(length) > ring->maxLength())
+			{
+				break; /*chunk is full*/
+			}
+			lengths.append(length);
+			span += ring->cellAlign(length);
+		}
+
+		MUtils::Internal::IPCRing::ticket_t ticket;
+		if(!ring->reserve(ticket, span, MUtils::Internal::IPCRing::INFINITE_TIMEOUT))
+		{
+			qWarning("Failed to reserve space in the IPC ring buffer!");
+			return false; /*only on a system error, after the previous chunks have been published*/
+		}
+
+		quint32 cursor = 0;
+		for(int i = 0; i < lengths.count(); i++)
+		{
+			const MUtils::IPCChannel::ipc_message_t &message = messages[offset + i];
+			frame_write(ticket.data + cursor, bodies[offset + i], message.command, message.flags, ticket.position + (cursor / MUtils::Internal::RING_CELL_SIZE));
+			cursor += ring->cellAlign(lengths[i]);
+		}
+
+		ring->publish(ticket, lengths.constData(), quint32(lengths.count()));
+		offset += lengths.count();
+	}
+
+	return true;
+}
+
+static bool ring_read_batch(MUtils::Internal::IPCRing *const ring, MUtils::Internal::frame_stash_t *const stash, QList<MUtils::IPCChannel::ipc_message_t> &messages, const quint32 &maxCount)
+{
+	MUtils::IPCChannel::ipc_message_t message;
+	while((quint32(messages.count()) < maxCount) && stash_read(stash, message.command, message.flags, &message.params, NULL, NULL))
+	{
+		messages.append(message);
+		message.params.clear();
+	}
+
+	QVector<MUtils::Internal::IPCRing::ticket_t> tickets(qMin(maxCount, MUtils::Internal::RING_BATCH_MAX));
+	while(messages.isEmpty())
+	{
+		const quint32 count = ring->acquire(tickets.data(), quint32(tickets.count()), MUtils::Internal::IPCRing::INFINITE_TIMEOUT);
+		if(count < 1)
+		{
+			qWarning("Failed to acquire a message from the IPC ring buffer!");
+			return false;
+		}
+
+		for(quint32 i = 0; i < count; i++)
+		{
+			if(frame_stash(stash, tickets[i].data, tickets[i].length, false, NULL))
+			{
+				continue;
+			}
+			if(frame_read(tickets[i].data, tickets[i].length, message.command, message.flags, &message.params, NULL))
+			{
+				messages.append(message);
+			}
+			message.params.clear();
+		}
+
+		ring->release(tickets.constData(), count);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BROADCAST MODE
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * In "broadcast" mode, the frames are stored in the slots of a shared ring that is *never* consumed: every subscriber reads all messages, using its own read cursor. The writers never wait for the subscribers, so a subscriber that does not keep up will miss messages.
+ */
+
+template<class T>
+static bool bcast_send(MUtils::Internal::IPCBroadcast *const broadcast, const quint32 &command, const quint32 &flags, const T &source)
+{
+	MUtils::Internal::frame_body_t body;
+	if(!frame_encode(source, body, broadcast->maxLength()))
+	{
+		return false;
+	}
+
+	quint32 position;
+	quint8 *const data = broadcast->reserve(position);
+	frame_write(data, body, command, flags, position);
+	broadcast->publish(position, body.length);
+	return true;
+}
+
+static bool bcast_read(MUtils::Internal::IPCBroadcast *const broadcast, MUtils::Internal::frame_stash_t *const stash, quint32 &command, quint32 &flags, QStringList *const params, MUtils::IPCPayload *const payload, const quint32 &timeout)
+{
+	if(stash_read(stash, command, flags, params, payload, NULL))
+	{
+		return true;
+	}
+
+	quint8 buffer[MUtils::Internal::BCAST_SLOT_SIZE];
+	const quint32 droppedBefore = broadcast->dropped();
+
+	forever
+	{
+		quint32 length;
+		if(!broadcast->read(buffer, length, timeout))
+		{
+			if(timeout == MUtils::Internal::IPCBroadcast::INFINITE_TIMEOUT)
+			{
+				qWarning("Failed to read a message from the IPC broadcast!");
+			}
+			return false;
+		}
+		if(const quint32 dropped = broadcast->dropped() - droppedBefore)
+		{
+			qWarning("IPC subscriber has fallen behind, %u message(s) have been dropped!", dropped);
+		}
+		if(frame_stash(stash, buffer, length, (payload != NULL), NULL))
+		{
+			continue;
+		}
+		if(frame_read(buffer, length, command, flags, params, payload))
+		{
+			return true;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PIPE MODE
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * In "pipe" mode, the frames are sent through a message-mode named pipe from the slaves to the master. There is no shared memory at all: the kernel buffers the messages and blocks the writers when the master does not keep up. Optionally, a handle can be passed along with each message.
+ */
+
+template<class T>
+static bool pipe_send(MUtils::Internal::IPCPipe *const pipe, const quint32 &command, const quint32 &flags, const T &source, void *const handle)
+{
+	MUtils::Internal::frame_body_t body;
+	if(!frame_encode(source, body, pipe->maxLength()))
+	{
+		return false;
+	}
+
+	QByteArray message(int(body.length), '\0');
+	frame_write(reinterpret_cast<quint8*>(message.data()), body, command, flags, 0U);
+	return pipe->send(message, handle);
+}
+
+/*
+ * A received handle has been created in *this* process by IPCPipe::read(), so it is returned only if the caller asked for a handle; otherwise it is closed
+ */
+static bool pipe_read(MUtils::Internal::IPCPipe *const pipe, MUtils::Internal::frame_stash_t *const stash, quint32 &command, quint32 &flags, QStringList *const params, MUtils::IPCPayload *const payload, void **const handle, const quint32 &timeout)
+{
+	if(stash_read(stash, command, flags, params, payload, handle))
+	{
+		return true;
+	}
+
+	forever
+	{
+		QByteArray message;
+		void *received = NULL;
+		if(!pipe->read(message, received, timeout))
+		{
+			if(timeout == MUtils::Internal::IPCPipe::INFINITE_TIMEOUT)
+			{
+				qWarning("Failed to read a message from the IPC pipe!");
+			}
+			return false;
+		}
+		if(frame_stash(stash, reinterpret_cast<const quint8*>(message.constData()), quint32(message.size()), (payload != NULL), received))
+		{
+			continue;
+		}
+		if(frame_read(reinterpret_cast<const quint8*>(message.constData()), quint32(message.size()), command, flags, params, payload))
+		{
+			if(handle)
+			{
+				*handle = received;
+			}
+			else
+			{
+				MUtils::Internal::IPCPipe::closeHandle(received);
+			}
+			return true;
+		}
+		MUtils::Internal::IPCPipe::closeHandle(received);
+	}
+}
+
+static void pipe_check(MUtils::Internal::IPCPipe *const pipe, const bool sending)
+{
+	if(pipe->role() != (sending ? MUtils::Internal::IPCPipe::ROLE_CLIENT : MUtils::Internal::IPCPipe::ROLE_SERVER))
+	{
+		MUTILS_THROW("In \"pipe\" mode, only the slaves can send and only the master can read.");
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCChannel::IPCChannel(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId, const int &mode)
+:
+	p(new IPCChannel_Private()),
+	m_applicationId(applicationId),
+	m_channelId(channelId),
+	m_appVersionNo(appVersionNo),
+	m_mode(mode),
+	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, channelId, HEADER_ID(mode)).toLatin1(), QCryptographicHash::Sha1).toHex())
+{
+	if(m_headerStr.length() != Internal::HDR_LEN)
+	{
+		MUTILS_THROW("Invalid header length has been detected!");
+	}
+}
+
+MUtils::IPCChannel::~IPCChannel(void)
+{
+	{
+		QMutexLocker locker(&g_notifier_lock);
+		for(QList<IPCNotifier*>::ConstIterator iter = p->notifiers.constBegin(); iter != p->notifiers.constEnd(); iter++)
+		{
+			p->ring->removeNotifier((*iter)->m_slot);
+			(*iter)->m_channel = NULL;
+		}
+	}
+
+	if(MUTILS_BOOLIFY(p->initialized) && (!p->sharedmem.isNull()))
+	{
+		if(p->sharedmem->isAttached())
+		{
+			p->sharedmem->detach();
+		}
+	}
+
+	for(QList<Internal::stash_frame_t>::ConstIterator iter = p->stash.frames.constBegin(); iter != p->stash.frames.constEnd(); iter++)
+	{
+		Internal::IPCPipe::closeHandle(iter->handle); /*handles that nobody has read*/
+	}
+
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::IPCChannel::initialize(void)
+{
+	QWriteLocker writeLock(&p->lock);
+	
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		return RET_ALREADY_INITIALIZED;
+	}
+
+	if(m_mode == MODE_PIPE)
+	{
+		p->pipe.reset(new Internal::IPCPipe());
+		switch(p->pipe->open(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "pipe")))
+		{
+		case Internal::IPCPipe::ROLE_SERVER:
+			p->initialized.ref();
+			return RET_SUCCESS_MASTER;
+		case Internal::IPCPipe::ROLE_CLIENT:
+			p->initialized.ref();
+			return RET_SUCCESS_SLAVE;
+		default:
+			qWarning("Failed to set up the IPC pipe!");
+			return RET_FAILURE;
+		}
+	}
+
+	const int segmentSize = (m_mode == MODE_RING) ? int(Internal::RING_SEGMENT_SIZE()) : ((m_mode == MODE_BROADCAST) ? int(Internal::BCAST_SEGMENT_SIZE()) : int(sizeof(Internal::ipc_lanes_t)));
+	const int minimumSize = (m_mode == MODE_SEMAPHORE) ? int(sizeof(Internal::ipc_t)) : segmentSize;
+	p->sharedmem.reset(new QSharedMemory(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "sharedmem"), 0));
+
+	if(m_mode == MODE_RING)
+	{
+		p->ring.reset(new Internal::IPCRing());
+	}
+	else if(m_mode == MODE_BROADCAST)
+	{
+		p->broadcast.reset(new Internal::IPCBroadcast());
+	}
+	else
+	{
+		p->semaphore_rd.reset(new Internal::IPCSemaphore());
+		if(!p->semaphore_rd->open(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_rd")))
+		{
+			qWarning("Failed to create system smaphore!");
+			return RET_FAILURE;
+		}
+
+		for(size_t lane = 0; lane < Internal::IPC_LANES; lane++)
+		{
+			p->semaphore_wr[lane].reset(new Internal::IPCSemaphore());
+			if(!p->semaphore_wr[lane]->open(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, SEMAPHORE_ID(lane))))
+			{
+				qWarning("Failed to create system smaphore!");
+				return RET_FAILURE;
+			}
+		}
+	}
+	
+	if(!p->sharedmem->create(segmentSize))
+	{
+		if(p->sharedmem->error() == QSharedMemory::AlreadyExists)
+		{
+			if(!p->sharedmem->attach())
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			if(p->sharedmem->error() != QSharedMemory::NoError)
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			if(p->sharedmem->size() < minimumSize)
+			{
+				qWarning("Failed to attach to shared memory: Size verification has failed!");
+				return RET_FAILURE;
+			}
+			if(char *const ptr = reinterpret_cast<char*>(p->sharedmem->data()))
+			{
+				if(memcmp(ptr, m_headerStr.constData(), Internal::HDR_LEN) != 0)
+				{
+					qWarning("Failed to attach to shared memory: Header verification has failed!");
+					return RET_FAILURE;
+				}
+				if(!p->ring.isNull())
+				{
+					if(!p->ring->attach(ptr + Internal::RING_OFFSET, size_t(p->sharedmem->size()) - Internal::RING_OFFSET, MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "ring")))
+					{
+						qWarning("Failed to attach to shared memory: Ring verification has failed!");
+						return RET_FAILURE;
+					}
+				}
+				if(!p->broadcast.isNull())
+				{
+					if(!p->broadcast->attach(ptr + Internal::RING_OFFSET, size_t(p->sharedmem->size()) - Internal::RING_OFFSET, MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "bcast")))
+					{
+						qWarning("Failed to attach to shared memory: Broadcast verification has failed!");
+						return RET_FAILURE;
+					}
+				}
+			}
+			else
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			//A segment that was created by a previous version does not have the priority lanes
+			p->lanes = (p->sharedmem->size() < segmentSize) ? 1U : Internal::IPC_LANES;
+			p->initialized.ref();
+			return RET_SUCCESS_SLAVE;
+		}
+		else
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+			return RET_FAILURE;
+		}
+	}
+	
+	if(p->sharedmem->error() != QSharedMemory::NoError)
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+
+	if((!p->ring.isNull()) || (!p->broadcast.isNull()))
+	{
+		if(char *const ptr = reinterpret_cast<char*>(p->sharedmem->data()))
+		{
+			memset(ptr, 0, Internal::RING_OFFSET);
+			memcpy(ptr, m_headerStr.constData(), Internal::HDR_LEN);
+			if((!p->ring.isNull()) && (!p->ring->create(ptr + Internal::RING_OFFSET, size_t(segmentSize) - Internal::RING_OFFSET, Internal::RING_CELLS, Internal::RING_CELL_SIZE, MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "ring"))))
+			{
+				qWarning("Failed to set up the IPC ring buffer!");
+				return RET_FAILURE;
+			}
+			if((!p->broadcast.isNull()) && (!p->broadcast->create(ptr + Internal::RING_OFFSET, size_t(segmentSize) - Internal::RING_OFFSET, Internal::BCAST_SLOTS, Internal::BCAST_SLOT_SIZE, MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "bcast"))))
+			{
+				qWarning("Failed to set up the IPC broadcast buffer!");
+				return RET_FAILURE;
+			}
+		}
+		else
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+			return RET_FAILURE;
+		}
+		p->initialized.ref();
+		return RET_SUCCESS_MASTER;
+	}
+
+	if(Internal::ipc_lanes_t *const ptr = reinterpret_cast<Internal::ipc_lanes_t*>(p->sharedmem->data()))
+	{
+		memset(ptr, 0, sizeof(Internal::ipc_lanes_t));
+		memcpy(&ptr->normal.header[0], m_headerStr.constData(), Internal::HDR_LEN);
+		UPDATE_CHECKSUM(ptr->normal.status);
+		for(size_t lane = 1; lane < Internal::IPC_LANES; lane++)
+		{
+			UPDATE_CHECKSUM(ptr->priority[lane - 1].status);
+		}
+	}
+	else
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+
+	for(size_t lane = 0; lane < Internal::IPC_LANES; lane++)
+	{
+		if(!p->semaphore_wr[lane]->release(quint32((lane > 0) ? Internal::IPC_SLOTS_PRIORITY : Internal::IPC_SLOTS)))
+		{
+			qWarning("Failed to release system semaphore!");
+			return RET_FAILURE;
+		}
+	}
+	
+	//qDebug("IPC KEY #1: %s", MUTILS_UTF8(p->sharedmem->key()));
+
+	p->lanes = Internal::IPC_LANES;
+	p->initialized.ref();
+	return RET_SUCCESS_MASTER;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SEND MESSAGE
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::send(const quint32 &command, const quint32 &flags, const QStringList &params)
+{
+	return send(command, flags, params, PRIORITY_NORMAL);
+}
+
+bool MUtils::IPCChannel::send(const quint32 &command, const quint32 &flags, const QStringList &params, const int &priority)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if((priority < PRIORITY_NORMAL) || (priority > PRIORITY_URGENT))
+	{
+		MUTILS_THROW("Invalid IPC priority has been specified!");
+	}
+
+	if((priority != PRIORITY_NORMAL) && (m_mode != MODE_SEMAPHORE))
+	{
+		MUTILS_THROW("Priority lanes are only supported in \"semaphore\" mode.");
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_send(p->ring.data(), command, flags, params, Internal::IPCRing::INFINITE_TIMEOUT);
+	}
+
+	if(!p->broadcast.isNull())
+	{
+		return bcast_send(p->broadcast.data(), command, flags, params);
+	}
+
+	if(!p->pipe.isNull())
+	{
+		pipe_check(p->pipe.data(), true);
+		return pipe_send(p->pipe.data(), command, flags, params, NULL);
+	}
+
+	QList<ipc_message_t> messages;
+	ipc_message_t message;
+	message.command = command;
+	message.flags = flags;
+	message.params = params;
+	messages.append(message);
+
+	//A segment that was created by a previous version does not have the priority lanes, so we fall back to the normal lane
+	return p->semaphoreSend(messages, qMin(size_t(priority), p->lanes - 1U));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// READ MESSAGE
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::read(quint32 &command, quint32 &flags, QStringList &params)
+{
+	return read(command, flags, params, Internal::IPCRing::INFINITE_TIMEOUT);
+}
+
+bool MUtils::IPCChannel::read(quint32 &command, quint32 &flags, QStringList &params, const quint32 &timeout)
+{
+	QReadLocker readLock(&p->lock);
+	command = 0;
+	params.clear();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_read(p->ring.data(), &p->stash, command, flags, &params, NULL, timeout);
+	}
+
+	if(!p->broadcast.isNull())
+	{
+		return bcast_read(p->broadcast.data(), &p->stash, command, flags, &params, NULL, timeout);
+	}
+
+	if(!p->pipe.isNull())
+	{
+		pipe_check(p->pipe.data(), false);
+		return pipe_read(p->pipe.data(), &p->stash, command, flags, &params, NULL, NULL, timeout);
+	}
+
+	QList<ipc_message_t> messages;
+	if(p->semaphoreRead(messages, 1U, timeout))
+	{
+		command = messages.first().command;
+		flags = messages.first().flags;
+		params = messages.first().params;
+		return true;
+	}
+
+	return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BATCH SEND & READ
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::sendBatch(const QList<ipc_message_t> &messages)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_send_batch(p->ring.data(), messages);
+	}
+
+	if(m_mode == MODE_SEMAPHORE)
+	{
+		return p->semaphoreSend(messages, 0U);
+	}
+
+	//Validate all messages up front, so nothing is sent unless the *whole* batch is valid
+	const quint32 maxLength = p->broadcast.isNull() ? p->pipe->maxLength() : p->broadcast->maxLength();
+	for(QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); iter++)
+	{
+		Internal::frame_body_t body;
+		if(!frame_encode(iter->params, body, maxLength))
+		{
+			return false;
+		}
+	}
+
+	readLock.unlock();
+	for(QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); iter++)
+	{
+		if(!send(iter->command, iter->flags, iter->params))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MUtils::IPCChannel::readBatch(QList<ipc_message_t> &messages, const quint32 &maxCount)
+{
+	QReadLocker readLock(&p->lock);
+	messages.clear();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(maxCount < 1)
+	{
+		return true;
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_read_batch(p->ring.data(), &p->stash, messages, maxCount);
+	}
+
+	if(!p->broadcast.isNull())
+	{
+		ipc_message_t message;
+		quint32 timeout = Internal::IPCBroadcast::INFINITE_TIMEOUT;
+		while((quint32(messages.count()) < maxCount) && bcast_read(p->broadcast.data(), &p->stash, message.command, message.flags, &message.params, NULL, timeout))
+		{
+			messages.append(message);
+			message.params.clear();
+			timeout = 0U;
+		}
+		return (!messages.isEmpty());
+	}
+
+	if(!p->pipe.isNull())
+	{
+		pipe_check(p->pipe.data(), false);
+		ipc_message_t message;
+		quint32 timeout = Internal::IPCPipe::INFINITE_TIMEOUT;
+		while((quint32(messages.count()) < maxCount) && pipe_read(p->pipe.data(), &p->stash, message.command, message.flags, &message.params, NULL, NULL, timeout))
+		{
+			messages.append(message);
+			message.params.clear();
+			timeout = 0U;
+		}
+		return (!messages.isEmpty());
+	}
+
+	return p->semaphoreRead(messages, maxCount, Internal::IPCSemaphore::INFINITE_TIMEOUT);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NON-BLOCKING READ
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::tryRead(quint32 &command, quint32 &flags, QStringList &params)
+{
+	return read(command, flags, params, 0U);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPED PAYLOAD
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The largest typed payload that fits into a single message, so that callers can reject oversized data *before* sending
+ */
+quint32 MUtils::IPCChannel::maxPayloadSize(void) const
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(m_mode == MODE_SEMAPHORE)
+	{
+		MUTILS_THROW("Typed payloads are not supported in \"semaphore\" mode.");
+	}
+
+	const quint32 maxLength = (!p->ring.isNull()) ? p->ring->maxLength() : ((!p->broadcast.isNull()) ? p->broadcast->maxLength() : p->pipe->maxLength());
+	return maxLength - quint32(sizeof(Internal::ipc_frame_t));
+}
+
+bool MUtils::IPCChannel::sendPayload(const quint32 &command, const quint32 &flags, const IPCPayload &payload)
+{
+	return sendPayload(command, flags, payload, Internal::IPCRing::INFINITE_TIMEOUT);
+}
+
+/*
+ * The timeout applies to "ring" mode only: in "broadcast" mode, the writers never block, and in "pipe" mode the kernel blocks the writers
+ */
+bool MUtils::IPCChannel::sendPayload(const quint32 &command, const quint32 &flags, const IPCPayload &payload, const quint32 &timeout)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(m_mode == MODE_SEMAPHORE)
+	{
+		MUTILS_THROW("Typed payloads are not supported in \"semaphore\" mode.");
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_send(p->ring.data(), command, flags, payload, timeout);
+	}
+
+	if(!p->broadcast.isNull())
+	{
+		return bcast_send(p->broadcast.data(), command, flags, payload);
+	}
+
+	pipe_check(p->pipe.data(), true);
+	return pipe_send(p->pipe.data(), command, flags, payload, NULL);
+}
+
+bool MUtils::IPCChannel::readPayload(quint32 &command, quint32 &flags, IPCPayload &payload)
+{
+	return readPayload(command, flags, payload, Internal::IPCRing::INFINITE_TIMEOUT);
+}
+
+bool MUtils::IPCChannel::readPayload(quint32 &command, quint32 &flags, IPCPayload &payload, const quint32 &timeout)
+{
+	QReadLocker readLock(&p->lock);
+	command = 0;
+	payload.clear();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(m_mode == MODE_SEMAPHORE)
+	{
+		MUTILS_THROW("Typed payloads are not supported in \"semaphore\" mode.");
+	}
+
+	if(!p->ring.isNull())
+	{
+		return ring_read(p->ring.data(), &p->stash, command, flags, NULL, &payload, timeout);
+	}
+
+	if(!p->broadcast.isNull())
+	{
+		return bcast_read(p->broadcast.data(), &p->stash, command, flags, NULL, &payload, timeout);
+	}
+
+	pipe_check(p->pipe.data(), false);
+	return pipe_read(p->pipe.data(), &p->stash, command, flags, NULL, &payload, NULL, timeout);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// HANDLE PASSING
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::sendHandle(const quint32 &command, const quint32 &flags, const QStringList &params, void *const handle)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(p->pipe.isNull())
+	{
+		MUTILS_THROW("Handle passing is only supported in \"pipe\" mode.");
+	}
+
+	pipe_check(p->pipe.data(), true);
+	return pipe_send(p->pipe.data(), command, flags, params, handle);
+}
+
+bool MUtils::IPCChannel::readHandle(quint32 &command, quint32 &flags, QStringList &params, void *&handle)
+{
+	QReadLocker readLock(&p->lock);
+	command = 0;
+	params.clear();
+	handle = NULL;
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(p->pipe.isNull())
+	{
+		MUTILS_THROW("Handle passing is only supported in \"pipe\" mode.");
+	}
+
+	pipe_check(p->pipe.data(), false);
+	return pipe_read(p->pipe.data(), &p->stash, command, flags, &params, NULL, &handle, Internal::IPCPipe::INFINITE_TIMEOUT);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTIFIER
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCNotifier::IPCNotifier(IPCChannel &channel, QObject *const parent)
+:
+	QObject(parent),
+	m_channel(&channel),
+	m_notifier(NULL),
+	m_event(NULL),
+	m_slot(0)
+{
+	QReadLocker readLock(&channel.p->lock);
+
+	if(!channel.p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(channel.p->ring.isNull())
+	{
+		MUTILS_THROW("Notifiers are only supported in \"ring\" mode.");
+	}
+
+	m_event = channel.p->ring->addNotifier(m_slot);
+	if(!m_event)
+	{
+		MUTILS_THROW("Failed to register the IPC notifier!");
+	}
+
+	QMutexLocker locker(&g_notifier_lock);
+	channel.p->notifiers.append(this);
+
+	m_notifier = new QWinEventNotifier(m_event, this);
+	connect(m_notifier, SIGNAL(activated(HANDLE)), this, SLOT(eventActivated()));
+	m_notifier->setEnabled(true);
+}
+
+MUtils::IPCNotifier::~IPCNotifier(void)
+{
+	m_notifier->setEnabled(false);
+	delete m_notifier;
+
+	{
+		QMutexLocker locker(&g_notifier_lock);
+		if(m_channel)
+		{
+			m_channel->p->ring->removeNotifier(m_slot);
+			m_channel->p->notifiers.removeAll(this);
+		}
+	}
+
+	Internal::IPCRing::closeNotifier(m_event);
+}
+
+bool MUtils::IPCNotifier::isPending(void) const
+{
+	QMutexLocker locker(&g_notifier_lock);
+	return m_channel && m_channel->p->ring->pending();
+}
+
+/*
+ * The signal is emitted again (from the event loop) as long as messages are pending, so a slot does *not* have to drain the ring completely
+ */
+void MUtils::IPCNotifier::eventActivated(void)
+{
+	if(isPending())
+	{
+		emit messagesPending();
+		if(isPending())
+		{
+			QMetaObject::invokeMethod(this, "eventActivated", Qt::QueuedConnection);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MESSAGE VIEW
+///////////////////////////////////////////////////////////////////////////////
+
+#define VIEW_FRAME (reinterpret_cast<const Internal::ipc_frame_t*>(m_data))
+
+MUtils::IPCMessageView::IPCMessageView(void)
+:
+	m_ring(NULL),
+	m_position(0),
+	m_length(0),
+	m_cells(0),
+	m_data(NULL),
+	m_cursorIndex(0),
+	m_cursorOffset(0)
+{
+}
+
+MUtils::IPCMessageView::~IPCMessageView(void)
+{
+	release();
+}
+
+void MUtils::IPCMessageView::release(void)
+{
+	if(m_ring)
+	{
+		Internal::IPCRing::ticket_t ticket;
+		ticket.position = m_position;
+		ticket.length = m_length;
+		ticket.cells = m_cells;
+		ticket.data = const_cast<quint8*>(m_data);
+		reinterpret_cast<Internal::IPCRing*>(m_ring)->release(ticket);
+		m_ring = NULL;
+		m_data = NULL;
+	}
+}
+
+quint32 MUtils::IPCMessageView::command(void) const
+{
+	return m_data ? VIEW_FRAME->command_id : 0U;
+}
+
+quint32 MUtils::IPCMessageView::flags(void) const
+{
+	return m_data ? VIEW_FRAME->flags : 0U;
+}
+
+quint32 MUtils::IPCMessageView::paramCount(void) const
+{
+	return (m_data && (VIEW_FRAME->param_count != Internal::FRAME_PAYLOAD)) ? VIEW_FRAME->param_count : 0U;
+}
+
+/*
+ * Returns a pointer to the UTF-8 encoded parameter (*not* NULL-terminated) inside of the shared memory. The position of the last access is remembered, so iterating the parameters in order takes linear time.
+ */
+const char *MUtils::IPCMessageView::param(const quint32 &index, quint32 &length) const
+{
+	length = 0;
+	if(index >= paramCount())
+	{
+		return NULL;
+	}
+
+	if(index < m_cursorIndex)
+	{
+		m_cursorIndex = 0;
+		m_cursorOffset = sizeof(Internal::ipc_frame_t);
+	}
+
+	while(m_cursorIndex < index)
+	{
+		quint32 len;
+		memcpy(&len, m_data + m_cursorOffset, sizeof(quint32));
+		m_cursorOffset += quint32(sizeof(quint32)) + len;
+		m_cursorIndex++;
+	}
+
+	memcpy(&length, m_data + m_cursorOffset, sizeof(quint32));
+	return reinterpret_cast<const char*>(m_data + m_cursorOffset + sizeof(quint32));
+}
+
+bool MUtils::IPCChannel::readView(IPCMessageView &view)
+{
+	return readView(view, Internal::IPCRing::INFINITE_TIMEOUT);
+}
+
+bool MUtils::IPCChannel::readView(IPCMessageView &view, const quint32 &timeout)
+{
+	QReadLocker readLock(&p->lock);
+	view.release();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(p->ring.isNull())
+	{
+		MUTILS_THROW("Message views are only supported in \"ring\" mode.");
+	}
+
+	Internal::IPCRing::ticket_t ticket;
+	if(!p->ring->acquire(ticket, timeout))
+	{
+		if(timeout == Internal::IPCRing::INFINITE_TIMEOUT)
+		{
+			qWarning("Failed to acquire a message from the IPC ring buffer!");
+		}
+		return false;
+	}
+
+	if(!frame_verify(ticket.data, ticket.length))
+	{
+		p->ring->release(ticket);
+		return false;
 	}
 
-	return success;
+	view.m_ring = p->ring.data();
+	view.m_position = ticket.position;
+	view.m_length = ticket.length;
+	view.m_cells = ticket.cells;
+	view.m_data = ticket.data;
+	view.m_cursorIndex = 0;
+	view.m_cursorOffset = sizeof(Internal::ipc_frame_t);
+	return true;
 }
@@ -0,0 +1,292 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/IPCPayload.h>
+
+//CRT
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// UTILITIES
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Each element is encoded as: type (1 byte), length of the value (varint), value
+ * Integers are encoded as "zig-zag" varints, so that small negative values remain short
+ */
+
+static inline void put_varint(QByteArray &buffer, quint64 value)
+{
+	char temp[10];
+	int count = 0;
+	while(value >= 0x80)
+	{
+		temp[count++] = char((value & 0x7F) | 0x80);
+		value >>= 7;
+	}
+	temp[count++] = char(value);
+	buffer.append(temp, count);
+}
+
+static inline bool get_varint(const quint8 *&ptr, const quint8 *const end, quint64 &value)
+{
+	value = 0;
+	for(int shift = 0; (shift < 64) && (ptr < end); shift += 7)
+	{
+		const quint8 byte = *(ptr++);
+		value |= quint64(byte & 0x7F) << shift;
+		if(!(byte & 0x80))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static inline quint64 zigzag_encode(const qint64 &value)
+{
+	return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+static inline qint64 zigzag_decode(const quint64 &value)
+{
+	return qint64(value >> 1) ^ (-qint64(value & 1));
+}
+
+static inline int varint_size(quint64 value)
+{
+	int count = 1;
+	while(value >= 0x80)
+	{
+		value >>= 7;
+		count++;
+	}
+	return count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCPayload::IPCPayload(void)
+:
+	m_cursor(0)
+{
+}
+
+MUtils::IPCPayload::IPCPayload(const QByteArray &data)
+:
+	m_data(data),
+	m_cursor(0)
+{
+}
+
+void MUtils::IPCPayload::clear(void)
+{
+	m_data.clear();
+	m_cursor = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ENCODE
+///////////////////////////////////////////////////////////////////////////////
+
+void MUtils::IPCPayload::putInt(const qint64 &value)
+{
+	const quint64 encoded = zigzag_encode(value);
+	m_data.append(char(TYPE_INT));
+	put_varint(m_data, quint64(varint_size(encoded)));
+	put_varint(m_data, encoded);
+}
+
+void MUtils::IPCPayload::putDouble(const double &value)
+{
+	m_data.append(char(TYPE_DOUBLE));
+	put_varint(m_data, sizeof(double));
+	m_data.append(reinterpret_cast<const char*>(&value), int(sizeof(double)));
+}
+
+void MUtils::IPCPayload::putBytes(const QByteArray &value)
+{
+	putBytes(value.constData(), quint32(value.size()));
+}
+
+void MUtils::IPCPayload::putBytes(const char *const data, const quint32 &length)
+{
+	m_data.append(char(TYPE_BYTES));
+	put_varint(m_data, length);
+	m_data.append(data, int(length));
+}
+
+/*
+ * The total length is known only after all strings have been encoded, so it is inserted afterwards
+ */
+void MUtils::IPCPayload::putStrings(const QStringList &value)
+{
+	m_data.append(char(TYPE_STRINGS));
+	const int start = m_data.size();
+	for(QStringList::ConstIterator iter = value.constBegin(); iter != value.constEnd(); iter++)
+	{
+		const QByteArray utf8 = iter->toUtf8();
+		put_varint(m_data, quint64(utf8.size()));
+		m_data.append(utf8);
+	}
+
+	QByteArray length;
+	put_varint(length, quint64(m_data.size() - start));
+	m_data.insert(start, length);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// DECODE
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::IPCPayload::nextType(void)
+{
+	const quint8 *const begin = reinterpret_cast<const quint8*>(m_data.constData());
+	const quint8 *const end = begin + m_data.size();
+
+	forever
+	{
+		const quint8 *ptr = begin + m_cursor;
+		if(ptr >= end)
+		{
+			return TYPE_NONE;
+		}
+		const int type = *(ptr++);
+		quint64 length;
+		if((!get_varint(ptr, end, length)) || (length > quint64(end - ptr)))
+		{
+			return TYPE_NONE; /*malformed*/
+		}
+		if((type >= TYPE_INT) && (type <= TYPE_STRINGS))
+		{
+			return type;
+		}
+		m_cursor = int((ptr + length) - begin); /*skip unknown element*/
+	}
+}
+
+bool MUtils::IPCPayload::getElement(const int &type, const quint8 *&data, quint32 &length)
+{
+	if(nextType() != type)
+	{
+		return false;
+	}
+
+	const quint8 *const begin = reinterpret_cast<const quint8*>(m_data.constData());
+	const quint8 *ptr = begin + m_cursor + 1;
+	quint64 value;
+	get_varint(ptr, begin + m_data.size(), value);
+
+	data = ptr;
+	length = quint32(value);
+	m_cursor = int((ptr + length) - begin);
+	return true;
+}
+
+bool MUtils::IPCPayload::getInt(qint64 &value)
+{
+	const int cursor = m_cursor;
+	const quint8 *data;
+	quint32 length;
+	if(getElement(TYPE_INT, data, length))
+	{
+		quint64 encoded;
+		if(get_varint(data, data + length, encoded))
+		{
+			value = zigzag_decode(encoded);
+			return true;
+		}
+		m_cursor = cursor;
+	}
+	return false;
+}
+
+bool MUtils::IPCPayload::getDouble(double &value)
+{
+	const int cursor = m_cursor;
+	const quint8 *data;
+	quint32 length;
+	if(getElement(TYPE_DOUBLE, data, length))
+	{
+		if(length == sizeof(double))
+		{
+			memcpy(&value, data, sizeof(double));
+			return true;
+		}
+		m_cursor = cursor;
+	}
+	return false;
+}
+
+bool MUtils::IPCPayload::getBytes(QByteArray &value)
+{
+	const char *data;
+	quint32 length;
+	if(getBytes(data, length))
+	{
+		value = QByteArray(data, int(length));
+		return true;
+	}
+	return false;
+}
+
+bool MUtils::IPCPayload::getBytes(const char *&data, quint32 &length)
+{
+	const quint8 *ptr;
+	if(getElement(TYPE_BYTES, ptr, length))
+	{
+		data = reinterpret_cast<const char*>(ptr);
+		return true;
+	}
+	return false;
+}
+
+/*
+ * The strings are decoded directly from the payload data
+ */
+bool MUtils::IPCPayload::getStrings(QStringList &value)
+{
+	const int cursor = m_cursor;
+	const quint8 *data;
+	quint32 length;
+	if(getElement(TYPE_STRINGS, data, length))
+	{
+		QStringList result;
+		const quint8 *const end = data + length;
+		while(data < end)
+		{
+			quint64 len;
+			if((!get_varint(data, end, len)) || (len > quint64(end - data)))
+			{
+				m_cursor = cursor;
+				return false;
+			}
+			result.append(QString::fromUtf8(reinterpret_cast<const char*>(data), int(len)));
+			data += len;
+		}
+		value = result;
+		return true;
+	}
+	return false;
+}
@@ -0,0 +1,387 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//Internal
+#include "IPCPipe_Win32.h"
+
+//Qt
+#include <QMutexLocker>
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+//CRT
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		struct pipe_instance_t
+		{
+			HANDLE pipe;
+			OVERLAPPED overlapped;
+			bool connected;
+			bool broken;
+			quint8 buffer[IPCPipe::MAX_MESSAGE];
+		};
+	}
+}
+
+/*
+ * Each message starts with a header that holds the value of the passed handle (in the context of the *client* process) and a flag that tells whether a handle has been passed at all
+ */
+typedef struct
+{
+	quint64 handle;
+	quint32 flags;
+	quint32 reserved;
+}
+msg_header_t;
+
+static const size_t MSG_HEADER = sizeof(msg_header_t);
+static const quint32 MSG_HAS_HANDLE = 0x00000001;
+
+#define CLIENT (reinterpret_cast<HANDLE>(m_client))
+
+static DWORD GET_CLIENT_PROCESS_ID(const HANDLE pipe)
+{
+	typedef BOOL(__stdcall *MyGetNamedPipeClientProcessId)(HANDLE Pipe, PULONG ClientProcessId);
+	if (const HMODULE kernel32 = GetModuleHandleW(L"kernel32"))
+	{
+		if (const MyGetNamedPipeClientProcessId pGetNamedPipeClientProcessId = (MyGetNamedPipeClientProcessId)GetProcAddress(kernel32, "GetNamedPipeClientProcessId"))
+		{
+			ULONG processId = 0;
+			if (pGetNamedPipeClientProcessId(pipe, &processId))
+			{
+				return processId;
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * The source handle is closed in the client process, even if the duplication fails
+ */
+static HANDLE TAKE_CLIENT_HANDLE(const HANDLE pipe, const quint64 value)
+{
+	HANDLE result = NULL;
+	const DWORD processId = GET_CLIENT_PROCESS_ID(pipe);
+	if (const HANDLE clientProcess = processId ? OpenProcess(PROCESS_DUP_HANDLE, FALSE, processId) : NULL)
+	{
+		if (!DuplicateHandle(clientProcess, reinterpret_cast<HANDLE>(quintptr(value)), GetCurrentProcess(), &result, 0, FALSE, DUPLICATE_SAME_ACCESS | DUPLICATE_CLOSE_SOURCE))
+		{
+			result = NULL;
+		}
+		CloseHandle(clientProcess);
+	}
+	if (!result)
+	{
+		qWarning("Failed to duplicate handle from the client process (error: %u)", GetLastError());
+	}
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::Internal::IPCPipe::IPCPipe(void)
+:
+	m_role(ROLE_NONE),
+	m_client(NULL)
+{
+}
+
+MUtils::Internal::IPCPipe::~IPCPipe(void)
+{
+	while (!m_instances.isEmpty())
+	{
+		removeInstance(m_instances.count() - 1);
+	}
+	if (m_client)
+	{
+		CloseHandle(CLIENT);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Whoever creates the first instance of the pipe becomes the server; everybody else connects as a client
+ */
+int MUtils::Internal::IPCPipe::open(const QString &pipeId)
+{
+	m_name = QString("\\\\.\\pipe\\%1").arg(pipeId);
+
+	if (addInstance(true))
+	{
+		m_role = ROLE_SERVER;
+		return m_role;
+	}
+
+	const DWORD error = GetLastError();
+	if ((error != ERROR_ACCESS_DENIED) && (error != ERROR_PIPE_BUSY))
+	{
+		qWarning("Failed to create named pipe \"%s\" (error: %u)", MUTILS_UTF8(m_name), error);
+		return ROLE_NONE;
+	}
+
+	if (connect())
+	{
+		m_role = ROLE_CLIENT;
+	}
+	return m_role;
+}
+
+bool MUtils::Internal::IPCPipe::connect(void)
+{
+	forever
+	{
+		const HANDLE pipe = CreateFileW(MUTILS_WCHR(m_name), GENERIC_WRITE | FILE_READ_ATTRIBUTES, 0, NULL, OPEN_EXISTING, 0, NULL);
+		if (pipe != INVALID_HANDLE_VALUE)
+		{
+			m_client = pipe;
+			return true;
+		}
+		const DWORD error = GetLastError();
+		if (error != ERROR_PIPE_BUSY)
+		{
+			qWarning("Failed to connect to named pipe \"%s\" (error: %u)", MUTILS_UTF8(m_name), error);
+			return false;
+		}
+		WaitNamedPipeW(MUTILS_WCHR(m_name), NMPWAIT_WAIT_FOREVER);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SERVER INSTANCES
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::Internal::IPCPipe::addInstance(const bool first)
+{
+	const HANDLE pipe = CreateNamedPipeW(MUTILS_WCHR(m_name), PIPE_ACCESS_INBOUND | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0), PIPE_TYPE_MESSAGE | PIPE_READMODE_MESSAGE | PIPE_WAIT, PIPE_UNLIMITED_INSTANCES, 0, MAX_MESSAGE, 0, NULL);
+	if (pipe == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	pipe_instance_t *const instance = new pipe_instance_t;
+	memset(&instance->overlapped, 0, sizeof(OVERLAPPED));
+	instance->pipe = pipe;
+	instance->connected = instance->broken = false;
+	instance->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+	m_instances.append(instance);
+
+	if (!ConnectNamedPipe(pipe, &instance->overlapped))
+	{
+		switch (GetLastError())
+		{
+		case ERROR_IO_PENDING:
+			break;
+		case ERROR_PIPE_CONNECTED:
+			SetEvent(instance->overlapped.hEvent);
+			break;
+		default:
+			instance->broken = true;
+			SetEvent(instance->overlapped.hEvent);
+			break;
+		}
+	}
+
+	return true;
+}
+
+void MUtils::Internal::IPCPipe::removeInstance(const int index)
+{
+	pipe_instance_t *const instance = m_instances.takeAt(index);
+	CancelIo(instance->pipe);
+	DisconnectNamedPipe(instance->pipe);
+	CloseHandle(instance->pipe);
+	CloseHandle(instance->overlapped.hEvent);
+	delete instance;
+}
+
+/*
+ * If the read completes immediately, the event is signalled all the same, so the completion is always handled in read()
+ */
+void MUtils::Internal::IPCPipe::startRead(pipe_instance_t *const instance)
+{
+	ResetEvent(instance->overlapped.hEvent);
+	if (!ReadFile(instance->pipe, instance->buffer, MAX_MESSAGE, NULL, &instance->overlapped))
+	{
+		const DWORD error = GetLastError();
+		if ((error != ERROR_IO_PENDING) && (error != ERROR_MORE_DATA))
+		{
+			instance->broken = true;
+			SetEvent(instance->overlapped.hEvent);
+		}
+	}
+}
+
+/*
+ * There must always be one instance that is waiting for the next client, unless the maximum number of wait objects has been reached
+ */
+void MUtils::Internal::IPCPipe::ensureListener(void)
+{
+	for (QVector<pipe_instance_t*>::ConstIterator iter = m_instances.constBegin(); iter != m_instances.constEnd(); iter++)
+	{
+		if (!(*iter)->connected)
+		{
+			return;
+		}
+	}
+	if ((m_instances.count() < MAXIMUM_WAIT_OBJECTS) && (!addInstance(false)))
+	{
+		qWarning("Failed to create named pipe instance (error: %u)", GetLastError());
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SEND & READ
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The handle is passed as a private duplicate, which stays open until the server takes it over; this way the caller may close its own handle right away
+ */
+bool MUtils::Internal::IPCPipe::send(const QByteArray &message, void *const handle)
+{
+	QMutexLocker lock(&m_mutex);
+	HANDLE duplicate = NULL;
+
+	if (handle && (!DuplicateHandle(GetCurrentProcess(), handle, GetCurrentProcess(), &duplicate, 0, FALSE, DUPLICATE_SAME_ACCESS)))
+	{
+		qWarning("Failed to duplicate handle (error: %u)", GetLastError());
+		return false;
+	}
+
+	msg_header_t header;
+	memset(&header, 0, sizeof(msg_header_t));
+	header.handle = quint64(reinterpret_cast<quintptr>(duplicate));
+	header.flags = duplicate ? MSG_HAS_HANDLE : 0U;
+
+	QByteArray buffer(reinterpret_cast<const char*>(&header), int(MSG_HEADER));
+	buffer.append(message);
+
+	DWORD written = 0;
+	const bool success = WriteFile(CLIENT, buffer.constData(), DWORD(buffer.size()), &written, NULL) && (written == DWORD(buffer.size()));
+	if (!success)
+	{
+		qWarning("Failed to write to named pipe (error: %u)", GetLastError());
+		if (duplicate)
+		{
+			CloseHandle(duplicate);
+		}
+	}
+
+	return success;
+}
+
+/*
+ * Wait for *any* of the pipe instances to complete its pending operation: a completed "connect" starts reading from the new client, a completed "read" yields the next message, a disconnected client is cleaned up
+ */
+bool MUtils::Internal::IPCPipe::read(QByteArray &message, void *&handle, const quint32 timeout)
+{
+	QMutexLocker lock(&m_mutex);
+	handle = NULL;
+
+	const DWORD startTime = GetTickCount();
+	forever
+	{
+		ensureListener();
+
+		HANDLE events[MAXIMUM_WAIT_OBJECTS];
+		const int count = m_instances.count();
+		for (int i = 0; i < count; ++i)
+		{
+			events[i] = m_instances[i]->overlapped.hEvent;
+		}
+
+		DWORD waitTime = INFINITE;
+		if (timeout != INFINITE_TIMEOUT)
+		{
+			const DWORD elapsed = GetTickCount() - startTime;
+			waitTime = (elapsed < timeout) ? (timeout - elapsed) : 0U;
+		}
+
+		const DWORD result = WaitForMultipleObjects(DWORD(count), events, FALSE, waitTime);
+		if ((result < WAIT_OBJECT_0) || (result >= (WAIT_OBJECT_0 + DWORD(count))))
+		{
+			if (result != WAIT_TIMEOUT)
+			{
+				qWarning("Failed to wait for named pipe (error: %u)", GetLastError());
+			}
+			return false;
+		}
+
+		const int index = int(result - WAIT_OBJECT_0);
+		pipe_instance_t *const instance = m_instances[index];
+		DWORD length = 0;
+		if (instance->broken || (!GetOverlappedResult(instance->pipe, &instance->overlapped, &length, FALSE)))
+		{
+			if ((!instance->broken) && (GetLastError() == ERROR_MORE_DATA))
+			{
+				qWarning("Oversized message received from named pipe, disconnecting client!");
+			}
+			removeInstance(index);
+			continue;
+		}
+
+		if (!instance->connected)
+		{
+			instance->connected = true;
+			startRead(instance);
+			continue;
+		}
+
+		if (length < MSG_HEADER)
+		{
+			qWarning("Malformed message received from named pipe, will be ignored!");
+			startRead(instance);
+			continue;
+		}
+
+		msg_header_t header;
+		memcpy(&header, instance->buffer, MSG_HEADER);
+		handle = (header.flags & MSG_HAS_HANDLE) ? TAKE_CLIENT_HANDLE(instance->pipe, header.handle) : NULL;
+		message = QByteArray(reinterpret_cast<const char*>(instance->buffer + MSG_HEADER), int(length - MSG_HEADER));
+		startRead(instance);
+		return true;
+	}
+}
+
+void MUtils::Internal::IPCPipe::closeHandle(void *const handle)
+{
+	if (handle)
+	{
+		CloseHandle(handle);
+	}
+}
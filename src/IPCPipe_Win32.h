@@ -0,0 +1,91 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <QMutex>
+
+///////////////////////////////////////////////////////////////////////////////
+// IPC PIPE
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		struct pipe_instance_t;
+
+		/*
+		 * Message-mode named pipe with a single server (the receiving end) and any number of clients (the sending ends)
+		 *
+		 * The server keeps one pipe instance per connected client, plus one instance that is waiting for the next client, and waits for all of them at once using overlapped I/O. Writes block while the inbound buffer of the server is full, so the kernel provides the back-pressure.
+		 * Handles are passed by the server: the client sends a private duplicate of the handle, which the server moves into its own process (closing the client's duplicate) as soon as the message is received. So the server only holds handles that it has created itself, and the receiver must close every handle that it does not hand out.
+		 */
+		class IPCPipe
+		{
+		public:
+			static const quint32 INFINITE_TIMEOUT = 0xFFFFFFFF;
+			static const quint32 MAX_MESSAGE = 65536;
+
+			typedef enum
+			{
+				ROLE_NONE = 0,
+				ROLE_SERVER = 1,
+				ROLE_CLIENT = 2
+			}
+			pipe_role_t;
+
+			IPCPipe(void);
+			~IPCPipe(void);
+
+			int open(const QString &pipeId);
+			inline int role(void) const { return m_role; }
+			inline quint32 maxLength(void) const { return MAX_MESSAGE - 16U; /*message header*/ }
+
+			bool send(const QByteArray &message, void *const handle);
+			bool read(QByteArray &message, void *&handle, const quint32 timeout);
+
+			static void closeHandle(void *const handle);
+
+		private:
+			MUTILS_NO_COPY(IPCPipe)
+
+			bool addInstance(const bool first);
+			void removeInstance(const int index);
+			void startRead(pipe_instance_t *const instance);
+			void ensureListener(void);
+			bool connect(void);
+
+			QString m_name;
+			int m_role;
+			void *m_client;
+			QVector<pipe_instance_t*> m_instances;
+			QMutex m_mutex;
+		};
+	}
+}
@@ -0,0 +1,558 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//Internal
+#include "IPCRing_Win32.h"
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+//CRT
+#include <cstring>
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTANTS
+///////////////////////////////////////////////////////////////////////////////
+
+static const quint32 RING_MAGIC = 0x474E4952; //"RING"
+static const size_t  CACHE_LINE = 64U;
+static const quint32 SPIN_COUNT = 256U;
+static const quint32 PAD_RECORD = 0xFFFFFFFF;
+
+#define ALIGN_UP(X) (((X) + (CACHE_LINE - 1U)) & (~(CACHE_LINE - 1U)))
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The positions, which are modified by the writers and readers respectively, are kept in separate cache lines
+ */
+typedef struct
+{
+	quint32       magic;
+	quint32       cell_count;
+	quint32       cell_size;
+	quint32       reserved;
+	quint8        padding0[CACHE_LINE - (4U * sizeof(quint32))];
+	volatile LONG pos_wr;
+	quint8        padding1[CACHE_LINE - sizeof(LONG)];
+	volatile LONG pos_rd;
+	quint8        padding2[CACHE_LINE - sizeof(LONG)];
+	volatile LONG sleep_rd;
+	volatile LONG sleep_wr;
+	volatile LONG notifiers;
+	quint8        padding3[CACHE_LINE - (3U * sizeof(LONG))];
+	volatile LONG notify_slot[MUtils::Internal::IPCRing::MAX_NOTIFIERS]; /*exactly one cache line*/
+}
+ring_header_t;
+
+#define HEADER (reinterpret_cast<ring_header_t*>(m_header))
+#define CELL_INDEX(X) ((X) & (m_cellCount - 1U))
+#define CELL_COUNT(X) (((X) > m_cellSize) ? (((X) + (m_cellSize - 1U)) / m_cellSize) : 1U)
+
+static inline bool VALID_GEOMETRY(const quint32 cellCount, const quint32 cellSize)
+{
+	return (cellCount >= 2U) && (!(cellCount & (cellCount - 1U))) && (cellSize >= 8U) && (!(cellSize & 7U));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::Internal::IPCRing::IPCRing(void)
+:
+	m_cellCount(0U),
+	m_cellSize(0U),
+	m_header(NULL),
+	m_sequence(NULL),
+	m_length(NULL),
+	m_data(NULL),
+	m_semaphoreRd(NULL),
+	m_semaphoreWr(NULL)
+{
+	for (quint32 i = 0; i < MAX_NOTIFIERS; ++i)
+	{
+		m_eventNotify[i] = NULL;
+	}
+}
+
+MUtils::Internal::IPCRing::~IPCRing(void)
+{
+	if (m_semaphoreRd)
+	{
+		CloseHandle(m_semaphoreRd);
+	}
+	if (m_semaphoreWr)
+	{
+		CloseHandle(m_semaphoreWr);
+	}
+	for (quint32 i = 0; i < MAX_NOTIFIERS; ++i)
+	{
+		if (m_eventNotify[i])
+		{
+			CloseHandle(m_eventNotify[i]);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+size_t MUtils::Internal::IPCRing::required_size(const quint32 cellCount, const quint32 cellSize)
+{
+	return sizeof(ring_header_t) + (2U * ALIGN_UP(cellCount * sizeof(LONG))) + (size_t(cellCount) * cellSize);
+}
+
+bool MUtils::Internal::IPCRing::create(void *const buffer, const size_t size, const quint32 cellCount, const quint32 cellSize, const QString &wakeupId)
+{
+	if ((!VALID_GEOMETRY(cellCount, cellSize)) || (size < required_size(cellCount, cellSize)))
+	{
+		qWarning("Invalid ring geometry has been specified!");
+		return false;
+	}
+
+	if (!open(wakeupId))
+	{
+		return false;
+	}
+
+	setup(buffer, cellCount, cellSize);
+
+	memset(HEADER, 0, sizeof(ring_header_t));
+	HEADER->cell_count = cellCount;
+	HEADER->cell_size = cellSize;
+	for (quint32 i = 0; i < cellCount; ++i)
+	{
+		m_sequence[i] = LONG(i);
+		m_length[i] = 0;
+	}
+
+	MemoryBarrier();
+	HEADER->magic = RING_MAGIC;
+	return true;
+}
+
+bool MUtils::Internal::IPCRing::attach(void *const buffer, const size_t size, const QString &wakeupId)
+{
+	const ring_header_t *const header = reinterpret_cast<const ring_header_t*>(buffer);
+	if ((size < sizeof(ring_header_t)) || (header->magic != RING_MAGIC))
+	{
+		qWarning("Ring header is missing or corrupted!");
+		return false;
+	}
+
+	const quint32 cellCount = header->cell_count, cellSize = header->cell_size;
+	if ((!VALID_GEOMETRY(cellCount, cellSize)) || (size < required_size(cellCount, cellSize)))
+	{
+		qWarning("Ring geometry verification has failed!");
+		return false;
+	}
+
+	if (!open(wakeupId))
+	{
+		return false;
+	}
+
+	setup(buffer, cellCount, cellSize);
+	return true;
+}
+
+void MUtils::Internal::IPCRing::setup(void *const buffer, const quint32 cellCount, const quint32 cellSize)
+{
+	quint8 *const base = reinterpret_cast<quint8*>(buffer);
+	m_header = buffer;
+	m_cellCount = cellCount;
+	m_cellSize = cellSize;
+	m_sequence = reinterpret_cast<volatile LONG*>(base + sizeof(ring_header_t));
+	m_length = reinterpret_cast<volatile LONG*>(base + sizeof(ring_header_t) + ALIGN_UP(cellCount * sizeof(LONG)));
+	m_data = base + sizeof(ring_header_t) + (2U * ALIGN_UP(cellCount * sizeof(LONG)));
+}
+
+bool MUtils::Internal::IPCRing::open(const QString &wakeupId)
+{
+	const QString nameRd(wakeupId + QLatin1String("_rd")), nameWr(wakeupId + QLatin1String("_wr"));
+
+	m_semaphoreRd = CreateSemaphoreW(NULL, 0, LONG_MAX, MUTILS_WCHR(nameRd));
+	if (!m_semaphoreRd)
+	{
+		qWarning("Failed to create semaphore \"%s\" (error: %u)", MUTILS_UTF8(nameRd), GetLastError());
+		return false;
+	}
+
+	m_semaphoreWr = CreateSemaphoreW(NULL, 0, LONG_MAX, MUTILS_WCHR(nameWr));
+	if (!m_semaphoreWr)
+	{
+		qWarning("Failed to create semaphore \"%s\" (error: %u)", MUTILS_UTF8(nameWr), GetLastError());
+		return false;
+	}
+
+	m_wakeupId = wakeupId;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WRITER
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::Internal::IPCRing::reserve(ticket_t &ticket, const quint32 length, const quint32 timeout)
+{
+	if (length > maxLength())
+	{
+		qWarning("Record size exceeds the capacity of the ring!");
+		return false;
+	}
+
+	quint32 count = 1U;
+	ticket.length = length;
+	return wait(&IPCRing::tryReserve, &HEADER->sleep_wr, m_semaphoreWr, &ticket, count, timeout);
+}
+
+void MUtils::Internal::IPCRing::publish(const ticket_t &ticket)
+{
+	publish(ticket, &ticket.length, 1U);
+}
+
+/*
+ * Publish a sequence of records that have been laid out, each one starting at a cell boundary, in the space of a single reservation
+ */
+void MUtils::Internal::IPCRing::publish(const ticket_t &ticket, const quint32 *const lengths, const quint32 count)
+{
+	quint32 position = ticket.position;
+	for (quint32 i = 0; i < count; ++i)
+	{
+		const quint32 index = CELL_INDEX(position);
+		m_length[index] = LONG(lengths[i]);
+		InterlockedExchange(&m_sequence[index], LONG(position + 1U));
+		position += CELL_COUNT(lengths[i]);
+	}
+	wake(&HEADER->sleep_rd, m_semaphoreRd, count);
+	if (HEADER->notifiers > 0)
+	{
+		notify();
+	}
+}
+
+/*
+ * A reservation never wraps around the end of the ring; if it doesn't fit, the remaining cells are reserved as a "padding" record, which the readers will skip
+ */
+bool MUtils::Internal::IPCRing::tryReserve(ticket_t *const tickets, quint32 &count)
+{
+	const quint32 cells = CELL_COUNT(tickets[0].length);
+	forever
+	{
+		const quint32 position = quint32(HEADER->pos_wr);
+		const quint32 index = CELL_INDEX(position);
+		const quint32 padding = ((index + cells) > m_cellCount) ? (m_cellCount - index) : 0U;
+
+		bool retry = false;
+		for (quint32 i = 0; i < padding + cells; ++i)
+		{
+			const qint32 diff = qint32(quint32(m_sequence[CELL_INDEX(position + i)]) - (position + i));
+			if (diff < 0)
+			{
+				return false; /*ring is full*/
+			}
+			if (diff > 0)
+			{
+				retry = true; /*position is stale*/
+				break;
+			}
+		}
+
+		if ((!retry) && (quint32(InterlockedCompareExchange(&HEADER->pos_wr, LONG(position + padding + cells), LONG(position))) == position))
+		{
+			if (padding > 0U)
+			{
+				m_length[index] = LONG(PAD_RECORD);
+				InterlockedExchange(&m_sequence[index], LONG(position + 1U));
+			}
+			tickets[0].position = position + padding;
+			tickets[0].cells = cells;
+			tickets[0].data = m_data + (size_t(CELL_INDEX(tickets[0].position)) * m_cellSize);
+			count = 1U;
+			return true;
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// READER
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::Internal::IPCRing::acquire(ticket_t &ticket, const quint32 timeout)
+{
+	quint32 count = 1U;
+	return wait(&IPCRing::tryAcquire, &HEADER->sleep_rd, m_semaphoreRd, &ticket, count, timeout);
+}
+
+quint32 MUtils::Internal::IPCRing::acquire(ticket_t *const tickets, const quint32 maxCount, const quint32 timeout)
+{
+	quint32 count = maxCount;
+	return ((maxCount > 0U) && wait(&IPCRing::tryAcquire, &HEADER->sleep_rd, m_semaphoreRd, tickets, count, timeout)) ? count : 0U;
+}
+
+void MUtils::Internal::IPCRing::release(const ticket_t &ticket)
+{
+	release(&ticket, 1U);
+}
+
+/*
+ * The tickets must have been returned by a *single* call to acquire(), so they refer to consecutive records
+ */
+void MUtils::Internal::IPCRing::release(const ticket_t *const tickets, const quint32 count)
+{
+	if (count > 0U)
+	{
+		const ticket_t &last = tickets[count - 1U];
+		releaseCells(tickets[0].position, (last.position + last.cells) - tickets[0].position);
+		wake(&HEADER->sleep_wr, m_semaphoreWr, count);
+	}
+}
+
+/*
+ * Claim as many consecutive published records as possible (up to "count") with a single update of the read position
+ */
+bool MUtils::Internal::IPCRing::tryAcquire(ticket_t *const tickets, quint32 &count)
+{
+	forever
+	{
+		const quint32 position = quint32(HEADER->pos_rd);
+		const qint32 diff = qint32(quint32(m_sequence[CELL_INDEX(position)]) - (position + 1U));
+		if (diff < 0)
+		{
+			return false; /*ring is empty*/
+		}
+		if (diff > 0)
+		{
+			continue; /*position is stale*/
+		}
+
+		quint32 records = 0U, cells = 0U;
+		while (records < count)
+		{
+			const quint32 current = position + cells, index = CELL_INDEX(current);
+			if (quint32(m_sequence[index]) != (current + 1U))
+			{
+				break; /*not published yet*/
+			}
+			const quint32 length = quint32(m_length[index]);
+			if (length == PAD_RECORD)
+			{
+				if (records < 1U)
+				{
+					cells = m_cellCount - index;
+				}
+				break;
+			}
+			const quint32 recordCells = qMin(CELL_COUNT(length), m_cellCount - index);
+			tickets[records].position = current;
+			tickets[records].length = qMin(length, recordCells * m_cellSize);
+			tickets[records].cells = recordCells;
+			tickets[records].data = m_data + (size_t(index) * m_cellSize);
+			cells += recordCells;
+			records++;
+		}
+
+		if ((cells > 0U) && (quint32(InterlockedCompareExchange(&HEADER->pos_rd, LONG(position + cells), LONG(position))) == position))
+		{
+			if (records < 1U)
+			{
+				releaseCells(position, cells); /*skip the padding*/
+				wake(&HEADER->sleep_wr, m_semaphoreWr, 1U);
+				continue;
+			}
+			count = records;
+			return true;
+		}
+	}
+}
+
+bool MUtils::Internal::IPCRing::pending(void) const
+{
+	const quint32 position = quint32(HEADER->pos_rd);
+	return (quint32(m_sequence[CELL_INDEX(position)]) == (position + 1U));
+}
+
+void MUtils::Internal::IPCRing::releaseCells(const quint32 position, const quint32 count)
+{
+	MemoryBarrier();
+	for (quint32 i = 0; i < count; ++i)
+	{
+		m_sequence[CELL_INDEX(position + i)] = LONG(position + i + m_cellCount);
+	}
+	MemoryBarrier();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTIFICATION
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Each notifier owns a slot with a separate (auto-reset) event, so *all* of them are signalled after a publish. The returned handle belongs to the caller and must be closed with closeNotifier(), even after the ring has gone away.
+ */
+void *MUtils::Internal::IPCRing::addNotifier(quint32 &slot)
+{
+	for (slot = 0; slot < MAX_NOTIFIERS; ++slot)
+	{
+		if (InterlockedCompareExchange(&HEADER->notify_slot[slot], 1, 0) == 0)
+		{
+			const QString nameEv(QString("%1_ev%2").arg(m_wakeupId, QString::number(slot)));
+			const HANDLE event = CreateEventW(NULL, FALSE, FALSE, MUTILS_WCHR(nameEv));
+			if (!event)
+			{
+				qWarning("Failed to create event \"%s\" (error: %u)", MUTILS_UTF8(nameEv), GetLastError());
+				InterlockedExchange(&HEADER->notify_slot[slot], 0);
+				return NULL;
+			}
+			InterlockedIncrement(&HEADER->notifiers);
+			if (pending())
+			{
+				SetEvent(event);
+			}
+			return event;
+		}
+	}
+
+	qWarning("Too many notifiers have been registered with the ring!");
+	return NULL;
+}
+
+void MUtils::Internal::IPCRing::removeNotifier(const quint32 slot)
+{
+	if (slot < MAX_NOTIFIERS)
+	{
+		InterlockedExchange(&HEADER->notify_slot[slot], 0);
+		InterlockedDecrement(&HEADER->notifiers);
+	}
+}
+
+void MUtils::Internal::IPCRing::closeNotifier(void *const event)
+{
+	if (event)
+	{
+		CloseHandle(event);
+	}
+}
+
+/*
+ * The writers open the event of a slot on first use; concurrent writers race with InterlockedCompareExchangePointer() and the loser closes its handle again
+ */
+void MUtils::Internal::IPCRing::notify(void)
+{
+	for (quint32 slot = 0; slot < MAX_NOTIFIERS; ++slot)
+	{
+		if (HEADER->notify_slot[slot] == 0)
+		{
+			continue;
+		}
+		HANDLE event = m_eventNotify[slot];
+		if (!event)
+		{
+			const QString nameEv(QString("%1_ev%2").arg(m_wakeupId, QString::number(slot)));
+			if (const HANDLE created = CreateEventW(NULL, FALSE, FALSE, MUTILS_WCHR(nameEv)))
+			{
+				event = InterlockedCompareExchangePointer(&m_eventNotify[slot], created, NULL);
+				if (event)
+				{
+					CloseHandle(created); /*another thread was faster*/
+				}
+				else
+				{
+					event = created;
+				}
+			}
+		}
+		if (event)
+		{
+			SetEvent(event);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WAIT & WAKE-UP
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Spin for a short while, then announce that we are going to sleep and re-check before actually blocking on the semaphore. The other side only signals the semaphore when it sees a sleeper, so no wake-up can get lost.
+ */
+bool MUtils::Internal::IPCRing::wait(const try_func_t tryFunc, volatile long *const sleepers, void *const semaphore, ticket_t *const tickets, quint32 &count, const quint32 timeout)
+{
+	for (quint32 spin = 0; spin < SPIN_COUNT; ++spin)
+	{
+		if ((this->*tryFunc)(tickets, count))
+		{
+			return true;
+		}
+		if (timeout < 1U)
+		{
+			return false; /*non-blocking*/
+		}
+		YieldProcessor();
+	}
+
+	const DWORD startTime = GetTickCount();
+	forever
+	{
+		InterlockedIncrement(sleepers);
+		if ((this->*tryFunc)(tickets, count))
+		{
+			InterlockedDecrement(sleepers);
+			return true;
+		}
+
+		DWORD waitTime = INFINITE;
+		if (timeout != INFINITE_TIMEOUT)
+		{
+			const DWORD elapsed = GetTickCount() - startTime;
+			waitTime = (elapsed < timeout) ? (timeout - elapsed) : 0U;
+		}
+
+		const DWORD result = (waitTime > 0U) ? WaitForSingleObject(semaphore, waitTime) : WAIT_TIMEOUT;
+		InterlockedDecrement(sleepers);
+
+		if (result != WAIT_OBJECT_0)
+		{
+			if (result != WAIT_TIMEOUT)
+			{
+				qWarning("Failed to wait for semaphore (error: %u)", GetLastError());
+			}
+			return (this->*tryFunc)(tickets, count);
+		}
+	}
+}
+
+/*
+ * Must be called *after* the sequence numbers have been updated by an interlocked (i.e. fully fenced) operation
+ */
+void MUtils::Internal::IPCRing::wake(volatile long *const sleepers, void *const semaphore, const quint32 count)
+{
+	const LONG waiting = *sleepers;
+	if (waiting > 0)
+	{
+		ReleaseSemaphore(semaphore, qMin(waiting, LONG(count)), NULL);
+	}
+}
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QString>
+
+///////////////////////////////////////////////////////////////////////////////
+// IPC RING
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		/*
+		 * Lock-free multi-producer/multi-consumer ring of variable-length records, located in a shared memory block
+		 *
+		 * The ring is divided into cells of a fixed size; a record occupies as many *consecutive* cells as needed, so its data is always contiguous. Cells are handed out by atomically advancing the write (read) position, and each cell carries a sequence number that tells whether it is free or published.
+		 * The wake-up semaphores are only signalled when a reader (writer) has announced that it is going to sleep, so the fast path never enters the kernel.
+		 */
+		class IPCRing
+		{
+		public:
+			static const quint32 INFINITE_TIMEOUT = 0xFFFFFFFF;
+			static const quint32 MAX_NOTIFIERS = 16;
+
+			typedef struct
+			{
+				quint32 position;
+				quint32 length;
+				quint32 cells;
+				quint8 *data;
+			}
+			ticket_t;
+
+			static size_t required_size(const quint32 cellCount, const quint32 cellSize);
+
+			IPCRing(void);
+			~IPCRing(void);
+
+			bool create(void *const buffer, const size_t size, const quint32 cellCount, const quint32 cellSize, const QString &wakeupId);
+			bool attach(void *const buffer, const size_t size, const QString &wakeupId);
+
+			bool reserve(ticket_t &ticket, const quint32 length, const quint32 timeout);
+			void publish(const ticket_t &ticket);
+			void publish(const ticket_t &ticket, const quint32 *const lengths, const quint32 count);
+
+			bool acquire(ticket_t &ticket, const quint32 timeout);
+			quint32 acquire(ticket_t *const tickets, const quint32 maxCount, const quint32 timeout);
+			void release(const ticket_t &ticket);
+			void release(const ticket_t *const tickets, const quint32 count);
+			bool pending(void) const;
+
+			void *addNotifier(quint32 &slot);
+			void removeNotifier(const quint32 slot);
+			static void closeNotifier(void *const event);
+
+			inline quint32 maxLength(void) const { return (m_cellCount / 2U) * m_cellSize; }
+			inline quint32 cellAlign(const quint32 length) const { return qMax(1U, (length + (m_cellSize - 1U)) / m_cellSize) * m_cellSize; }
+
+		private:
+			MUTILS_NO_COPY(IPCRing)
+
+			typedef bool (IPCRing::*try_func_t)(ticket_t *const tickets, quint32 &count);
+
+			bool open(const QString &wakeupId);
+			void setup(void *const buffer, const quint32 cellCount, const quint32 cellSize);
+			bool tryReserve(ticket_t *const tickets, quint32 &count);
+			bool tryAcquire(ticket_t *const tickets, quint32 &count);
+			void releaseCells(const quint32 position, const quint32 count);
+			bool wait(const try_func_t tryFunc, volatile long *const sleepers, void *const semaphore, ticket_t *const tickets, quint32 &count, const quint32 timeout);
+			void wake(volatile long *const sleepers, void *const semaphore, const quint32 count);
+			void notify(void);
+
+			quint32 m_cellCount;
+			quint32 m_cellSize;
+			void *m_header;
+			volatile long *m_sequence;
+			volatile long *m_length;
+			quint8 *m_data;
+			void *m_semaphoreRd;
+			void *m_semaphoreWr;
+			void *volatile m_eventNotify[MAX_NOTIFIERS];
+			QString m_wakeupId;
+		};
+	}
+}
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//Internal
+#include "IPCSemaphore_Win32.h"
+
+//Qt
+#include <QCryptographicHash>
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+///////////////////////////////////////////////////////////////////////////////
+// UTILITIES
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Same as QSharedMemoryPrivate::makePlatformSafeKey(), which is used by QSystemSemaphore (Qt 4.x and Qt 5.x)
+ */
+static QString PLATFORM_KEY(const QString &key)
+{
+	QString result(QLatin1String("qipc_systemsem_"));
+	for (int i = 0; i < key.length(); ++i)
+	{
+		const QChar ch = key.at(i);
+		if (((ch >= QLatin1Char('a')) && (ch <= QLatin1Char('z'))) || ((ch >= QLatin1Char('A')) && (ch <= QLatin1Char('Z'))))
+		{
+			result.append(ch);
+		}
+	}
+	result.append(QLatin1String(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex()));
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::Internal::IPCSemaphore::IPCSemaphore(void)
+:
+	m_handle(NULL)
+{
+}
+
+MUtils::Internal::IPCSemaphore::~IPCSemaphore(void)
+{
+	if (m_handle)
+	{
+		CloseHandle(m_handle);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::Internal::IPCSemaphore::open(const QString &key)
+{
+	if (m_handle)
+	{
+		return true;
+	}
+
+	const QString name = PLATFORM_KEY(key);
+	m_handle = CreateSemaphoreW(NULL, 0, LONG_MAX, MUTILS_WCHR(name));
+	if (!m_handle)
+	{
+		qWarning("Failed to create semaphore \"%s\" (error: %u)", MUTILS_UTF8(name), GetLastError());
+		return false;
+	}
+
+	return true;
+}
+
+bool MUtils::Internal::IPCSemaphore::acquire(const quint32 timeout)
+{
+	const DWORD result = WaitForSingleObject(m_handle, (timeout == INFINITE_TIMEOUT) ? INFINITE : DWORD(timeout));
+	if (result != WAIT_OBJECT_0)
+	{
+		if (result != WAIT_TIMEOUT)
+		{
+			qWarning("Failed to wait for semaphore (error: %u)", GetLastError());
+		}
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Acquire as many units as are available right now (up to "maxCount"), without blocking
+ */
+quint32 MUtils::Internal::IPCSemaphore::tryAcquire(const quint32 maxCount)
+{
+	quint32 count = 0U;
+	while ((count < maxCount) && (WaitForSingleObject(m_handle, 0U) == WAIT_OBJECT_0))
+	{
+		count++;
+	}
+	return count;
+}
+
+bool MUtils::Internal::IPCSemaphore::release(const quint32 count)
+{
+	if ((count > 0U) && (!ReleaseSemaphore(m_handle, LONG(count), NULL)))
+	{
+		qWarning("Failed to release semaphore (error: %u)", GetLastError());
+		return false;
+	}
+	return true;
+}
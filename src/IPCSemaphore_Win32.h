@@ -0,0 +1,63 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QString>
+
+///////////////////////////////////////////////////////////////////////////////
+// IPC SEMAPHORE
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		/*
+		 * Named system semaphore that, unlike QSystemSemaphore, can be acquired with a timeout or without blocking
+		 *
+		 * The name is derived from the key exactly like QSystemSemaphore does it, so both refer to the *same* kernel object and processes that still use QSystemSemaphore can interoperate.
+		 */
+		class IPCSemaphore
+		{
+		public:
+			static const quint32 INFINITE_TIMEOUT = 0xFFFFFFFF;
+
+			IPCSemaphore(void);
+			~IPCSemaphore(void);
+
+			bool open(const QString &key);
+
+			bool acquire(const quint32 timeout);
+			quint32 tryAcquire(const quint32 maxCount);
+			bool release(const quint32 count);
+
+		private:
+			MUTILS_NO_COPY(IPCSemaphore)
+
+			void *m_handle;
+		};
+	}
+}
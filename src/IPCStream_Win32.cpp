@@ -0,0 +1,493 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/IPCStream.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Internal.h"
+#include "IPCRing_Win32.h"
+
+//Qt
+#include <QSharedMemory>
+#include <QReadWriteLock>
+#include <QCryptographicHash>
+#include <QIODevice>
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+//CRT
+#include <climits>
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		static const size_t  STREAM_HDR_LEN = 40;
+		static const size_t  STREAM_OFFSET = 64;
+		static const quint32 STREAM_CELLS = 8192;
+		static const quint32 STREAM_CELL_SIZE = 512;
+		static const quint32 CHUNK_MAGIC = 0x424F4C42; //"BLOB"
+
+		static const quint32 CHUNK_FIRST = 0x1;
+		static const quint32 CHUNK_LAST  = 0x2;
+		static const quint32 CHUNK_ABORT = 0x4;
+
+		typedef struct
+		{
+			quint32 magic;
+			quint32 tag;
+			quint32 flags;
+			quint32 length;
+			quint64 offset;
+			quint64 total;
+		}
+		chunk_header_t;
+
+		static inline size_t STREAM_SEGMENT_SIZE(void)
+		{
+			return STREAM_OFFSET + IPCRing::required_size(STREAM_CELLS, STREAM_CELL_SIZE);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// UTILITIES
+///////////////////////////////////////////////////////////////////////////////
+
+#define MAKE_ID(APP, VER, SCOPE, ITEM) MUtils::Internal::make_ipc_id("ipcstream", (APP), (VER), (SCOPE), (ITEM))
+
+/*
+ * The named mutexes ensure that the chunks of a blob are written (read) consecutively. If the owner of a mutex has terminated without releasing it, the blob it was transferring is incomplete, which the reader detects.
+ */
+static bool MUTEX_LOCK(const HANDLE mutex)
+{
+	const DWORD result = WaitForSingleObject(mutex, INFINITE);
+	if(result == WAIT_ABANDONED)
+	{
+		qWarning("Previous owner of the IPC stream has terminated unexpectedly!");
+		return true;
+	}
+	if(result != WAIT_OBJECT_0)
+	{
+		qWarning("Failed to lock the IPC stream (error: %u)", GetLastError());
+		return false;
+	}
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class IPCStream_Private
+	{
+		friend class IPCStream;
+
+	protected:
+		IPCStream_Private(void) : mutexWr(NULL), mutexRd(NULL) {}
+		~IPCStream_Private(void)
+		{
+			if(mutexWr)
+			{
+				CloseHandle(mutexWr);
+			}
+			if(mutexRd)
+			{
+				CloseHandle(mutexRd);
+			}
+		}
+
+		QAtomicInt initialized;
+		QScopedPointer<QSharedMemory> sharedmem;
+		Internal::IPCRing ring;
+		HANDLE mutexWr;
+		HANDLE mutexRd;
+		QReadWriteLock lock;
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCStream::IPCStream(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId)
+:
+	p(new IPCStream_Private()),
+	m_applicationId(applicationId),
+	m_channelId(channelId),
+	m_appVersionNo(appVersionNo),
+	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, channelId, "header").toLatin1(), QCryptographicHash::Sha1).toHex())
+{
+	if(m_headerStr.length() != Internal::STREAM_HDR_LEN)
+	{
+		MUTILS_THROW("Invalid header length has been detected!");
+	}
+}
+
+MUtils::IPCStream::~IPCStream(void)
+{
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		if(p->sharedmem->isAttached())
+		{
+			p->sharedmem->detach();
+		}
+	}
+
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::IPCStream::initialize(void)
+{
+	QWriteLocker writeLock(&p->lock);
+
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		return IPCChannel::RET_ALREADY_INITIALIZED;
+	}
+
+	const QString nameWr(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "mutex_wr")), nameRd(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "mutex_rd"));
+	p->mutexWr = CreateMutexW(NULL, FALSE, MUTILS_WCHR(nameWr));
+	if(!p->mutexWr)
+	{
+		qWarning("Failed to create mutex \"%s\" (error: %u)", MUTILS_UTF8(nameWr), GetLastError());
+		return IPCChannel::RET_FAILURE;
+	}
+	p->mutexRd = CreateMutexW(NULL, FALSE, MUTILS_WCHR(nameRd));
+	if(!p->mutexRd)
+	{
+		qWarning("Failed to create mutex \"%s\" (error: %u)", MUTILS_UTF8(nameRd), GetLastError());
+		return IPCChannel::RET_FAILURE;
+	}
+
+	const int segmentSize = int(Internal::STREAM_SEGMENT_SIZE());
+	const QString ringId(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "ring"));
+	p->sharedmem.reset(new QSharedMemory(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "sharedmem"), 0));
+
+	if(!p->sharedmem->create(segmentSize))
+	{
+		if(p->sharedmem->error() != QSharedMemory::AlreadyExists)
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(!p->sharedmem->attach())
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(p->sharedmem->size() < segmentSize)
+		{
+			qWarning("Failed to attach to shared memory: Size verification has failed!");
+			return IPCChannel::RET_FAILURE;
+		}
+		char *const ptr = reinterpret_cast<char*>(p->sharedmem->data());
+		if(!ptr)
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+			return IPCChannel::RET_FAILURE;
+		}
+		if(memcmp(ptr, m_headerStr.constData(), Internal::STREAM_HDR_LEN) != 0)
+		{
+			qWarning("Failed to attach to shared memory: Header verification has failed!");
+			return IPCChannel::RET_FAILURE;
+		}
+		if(!p->ring.attach(ptr + Internal::STREAM_OFFSET, size_t(p->sharedmem->size()) - Internal::STREAM_OFFSET, ringId))
+		{
+			qWarning("Failed to attach to shared memory: Ring verification has failed!");
+			return IPCChannel::RET_FAILURE;
+		}
+		p->initialized.ref();
+		return IPCChannel::RET_SUCCESS_SLAVE;
+	}
+
+	char *const ptr = reinterpret_cast<char*>(p->sharedmem->data());
+	if(!ptr)
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+		return IPCChannel::RET_FAILURE;
+	}
+
+	memset(ptr, 0, Internal::STREAM_OFFSET);
+	memcpy(ptr, m_headerStr.constData(), Internal::STREAM_HDR_LEN);
+	if(!p->ring.create(ptr + Internal::STREAM_OFFSET, size_t(segmentSize) - Internal::STREAM_OFFSET, Internal::STREAM_CELLS, Internal::STREAM_CELL_SIZE, ringId))
+	{
+		qWarning("Failed to set up the IPC ring buffer!");
+		return IPCChannel::RET_FAILURE;
+	}
+
+	p->initialized.ref();
+	return IPCChannel::RET_SUCCESS_MASTER;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WRITE BLOB
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCStream::write(const quint32 &tag, const QByteArray &data)
+{
+	return writeChunks(tag, data.constData(), NULL, quint64(data.size()));
+}
+
+bool MUtils::IPCStream::write(const quint32 &tag, QIODevice &input)
+{
+	return writeChunks(tag, NULL, &input, input.isSequential() ? 0U : quint64(qMax(input.size() - input.pos(), Q_INT64_C(0))));
+}
+
+/*
+ * The data is copied directly from the source into the space that was reserved in the ring; IPCRing::reserve() blocks while the ring is full
+ * A sequential device (e.g. QProcess or a socket) is at its end only when waitForReadyRead() fails, i.e. when the source has been closed
+ */
+bool MUtils::IPCStream::writeChunks(const quint32 &tag, const char *const data, QIODevice *const input, const quint64 &total)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!MUTEX_LOCK(p->mutexWr))
+	{
+		return false;
+	}
+
+	bool success = true;
+	quint64 offset = 0U;
+	quint32 flags = Internal::CHUNK_FIRST;
+	while(!(flags & Internal::CHUNK_LAST))
+	{
+		const quint32 capacity = input ? CHUNK_SIZE : quint32(qMin(quint64(CHUNK_SIZE), total - offset));
+		Internal::IPCRing::ticket_t ticket;
+		if(!p->ring.reserve(ticket, quint32(sizeof(Internal::chunk_header_t)) + capacity, Internal::IPCRing::INFINITE_TIMEOUT))
+		{
+			qWarning("Failed to reserve space in the IPC ring buffer!");
+			success = false;
+			break;
+		}
+
+		char *const payload = reinterpret_cast<char*>(ticket.data + sizeof(Internal::chunk_header_t));
+		quint32 length = 0U;
+		if(input)
+		{
+			bool eof = false;
+			while((length < capacity) && (!eof))
+			{
+				const qint64 count = input->read(payload + length, capacity - length);
+				if(count < 0)
+				{
+					qWarning("Failed to read input data, aborting the transfer!");
+					flags |= Internal::CHUNK_ABORT;
+					success = false;
+					break;
+				}
+				if(count > 0)
+				{
+					length += quint32(count);
+					continue;
+				}
+				eof = (!input->isSequential()) || (!input->waitForReadyRead(-1)); /*a sequential device may have no data *yet*, so a short read is not the end*/
+			}
+			if(eof || ((!input->isSequential()) && input->atEnd()))
+			{
+				flags |= Internal::CHUNK_LAST;
+			}
+		}
+		else
+		{
+			memcpy(payload, data + offset, capacity);
+			length = capacity;
+			if((offset + length) >= total)
+			{
+				flags |= Internal::CHUNK_LAST;
+			}
+		}
+
+		Internal::chunk_header_t *const header = reinterpret_cast<Internal::chunk_header_t*>(ticket.data);
+		header->magic = Internal::CHUNK_MAGIC;
+		header->tag = tag;
+		header->flags = (flags & Internal::CHUNK_ABORT) ? (flags | Internal::CHUNK_LAST) : flags;
+		header->length = length;
+		header->offset = offset;
+		header->total = total;
+		p->ring.publish(ticket);
+
+		offset += length;
+		flags = header->flags & (~Internal::CHUNK_FIRST);
+	}
+
+	ReleaseMutex(p->mutexWr);
+	return success;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// READ BLOB
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCStream::read(quint32 &tag, QByteArray &data)
+{
+	return readChunks(tag, &data, NULL);
+}
+
+bool MUtils::IPCStream::read(quint32 &tag, QIODevice &output)
+{
+	return readChunks(tag, NULL, &output);
+}
+
+/*
+ * Chunks that do not belong to the current blob, e.g. because the writer has terminated unexpectedly, are skipped. If an error occurs, the remaining chunks of the blob are consumed but discarded.
+ */
+bool MUtils::IPCStream::readChunks(quint32 &tag, QByteArray *const data, QIODevice *const output)
+{
+	QReadLocker readLock(&p->lock);
+	tag = 0;
+	if(data)
+	{
+		data->clear();
+	}
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!MUTEX_LOCK(p->mutexRd))
+	{
+		return false;
+	}
+
+	bool started = false, success = false, discard = false;
+	quint64 offset = 0U;
+	forever
+	{
+		Internal::IPCRing::ticket_t ticket;
+		if(!p->ring.acquire(ticket, Internal::IPCRing::INFINITE_TIMEOUT))
+		{
+			qWarning("Failed to acquire a chunk from the IPC ring buffer!");
+			break;
+		}
+
+		const Internal::chunk_header_t *const header = reinterpret_cast<const Internal::chunk_header_t*>(ticket.data);
+		if((ticket.length < sizeof(Internal::chunk_header_t)) || (header->magic != Internal::CHUNK_MAGIC) || (header->length > (ticket.length - sizeof(Internal::chunk_header_t))))
+		{
+			qWarning("Malformed IPC stream chunk, will be ignored!");
+			p->ring.release(ticket);
+			continue;
+		}
+
+		if(header->flags & Internal::CHUNK_FIRST)
+		{
+			if(started)
+			{
+				qWarning("Incomplete blob in IPC stream, discarding!");
+				if(output)
+				{
+					discard = true; /*can not undo what has been written to the device*/
+				}
+			}
+			started = true;
+			offset = 0U;
+			tag = header->tag;
+			if(data)
+			{
+				discard = false; /*the new blob replaces whatever was collected so far*/
+				data->clear();
+				if(header->total <= quint64(INT_MAX))
+				{
+					data->reserve(int(header->total));
+				}
+			}
+		}
+		else if((!started) || (header->offset != offset))
+		{
+			if(started)
+			{
+				qWarning("Out-of-order chunk in IPC stream, discarding the blob!");
+				discard = true;
+			}
+			p->ring.release(ticket);
+			continue;
+		}
+
+		const char *const payload = reinterpret_cast<const char*>(ticket.data + sizeof(Internal::chunk_header_t));
+		if((!discard) && data)
+		{
+			if((offset + header->length) > quint64(INT_MAX))
+			{
+				qWarning("Blob exceeds the maximum size of a QByteArray, discarding!");
+				discard = true;
+			}
+			else
+			{
+				data->append(payload, int(header->length));
+			}
+		}
+		if((!discard) && output)
+		{
+			if(output->write(payload, header->length) != qint64(header->length))
+			{
+				qWarning("Failed to write output data, discarding the blob!");
+				discard = true;
+			}
+		}
+
+		const quint32 flags = header->flags;
+		offset += header->length;
+		p->ring.release(ticket);
+
+		if(flags & Internal::CHUNK_LAST)
+		{
+			if(flags & Internal::CHUNK_ABORT)
+			{
+				qWarning("Transfer has been aborted by the writer!");
+			}
+			success = (!discard) && (!(flags & Internal::CHUNK_ABORT));
+			break;
+		}
+	}
+
+	ReleaseMutex(p->mutexRd);
+	if(data && (!success))
+	{
+		data->clear();
+	}
+	return success;
+}
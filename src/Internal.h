@@ -26,5 +26,10 @@ namespace MUtils
 	namespace Internal
 	{
 		extern const QString g_empty;
+
+		/*
+		 * Build a system-wide object name for the IPC classes: "com.muldersoft.mutilities.<prefix>.<app>.r<ver>.<scope>.<item>"
+		 */
+		QString make_ipc_id(const char *const prefix, const QString &applicationId, const unsigned int &appVersionNo, const QString &scopeId, const QString &itemId);
 	}
 }
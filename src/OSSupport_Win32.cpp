@@ -44,10 +44,10 @@
 #include "Internal.h"
 #include "CriticalSection_Win32.h"
 #include "Utils_Win32.h"
+#include "Snapshot.h"
 
 //Qt
 #include <QMap>
-#include <QReadWriteLock>
 #include <QDir>
 #include <QWidget>
 #include <QProcess>
@@ -81,8 +81,7 @@ void MUtils::OS::system_message_err(const wchar_t *const title, const wchar_t *c
 // FETCH CLI ARGUMENTS
 ///////////////////////////////////////////////////////////////////////////////
 
-static QReadWriteLock                          g_arguments_lock;
-static QScopedPointer<MUtils::OS::ArgumentMap> g_arguments_list;
+static MUtils::Internal::Snapshot<MUtils::OS::ArgumentMap> g_arguments_list;
 
 const QStringList MUtils::OS::crack_command_line(const QString &command_line)
 {
@@ -106,27 +105,10 @@ const QStringList MUtils::OS::crack_command_line(const QString &command_line)
 	return command_line_tokens;
 }
 
-const MUtils::OS::ArgumentMap &MUtils::OS::arguments(void)
+static MUtils::OS::ArgumentMap *parse_arguments(void)
 {
-	QReadLocker readLock(&g_arguments_lock);
-
-	//Already initialized?
-	if(!g_arguments_list.isNull())
-	{
-		return (*(g_arguments_list.data()));
-	}
-
-	readLock.unlock();
-	QWriteLocker writeLock(&g_arguments_lock);
-
-	//Still not initialized?
-	if(!g_arguments_list.isNull())
-	{
-		return (*(g_arguments_list.data()));
-	}
-
-	g_arguments_list.reset(new ArgumentMap());
-	const QStringList argList = crack_command_line();
+	MUtils::OS::ArgumentMap *const argumentMap = new MUtils::OS::ArgumentMap();
+	const QStringList argList = MUtils::OS::crack_command_line();
 
 	if(!argList.isEmpty())
 	{
@@ -151,11 +133,11 @@ const MUtils::OS::ArgumentMap &MUtils::OS::arguments(void)
 					{
 						const QString argKey = argData.left(separatorIndex).trimmed();
 						const QString argVal = argData.mid(separatorIndex + 1).trimmed();
-						g_arguments_list->insertMulti(argKey.toLower(), argVal);
+						argumentMap->insertMulti(argKey.toLower(), argVal);
 					}
 					else
 					{
-						g_arguments_list->insertMulti(argData.toLower(), QString());
+						argumentMap->insertMulti(argData.toLower(), QString());
 					}
 				}
 			}
@@ -166,7 +148,12 @@ const MUtils::OS::ArgumentMap &MUtils::OS::arguments(void)
 		qWarning("CommandLineToArgvW() has failed !!!");
 	}
 
-	return (*(g_arguments_list.data()));
+	return argumentMap;
+}
+
+const MUtils::OS::ArgumentMap &MUtils::OS::arguments(void)
+{
+	return *g_arguments_list.once(parse_arguments);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -269,9 +256,7 @@ bool MUtils::OS::get_file_version(const QString fileName, quint16 *const major,
 // OS VERSION DETECTION
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool g_os_version_initialized = false;
-static MUtils::OS::Version::os_version_t g_os_version_info = MUtils::OS::Version::UNKNOWN_OPSYS;
-static QReadWriteLock g_os_version_lock;
+static MUtils::Internal::Snapshot<MUtils::OS::Version::os_version_t> g_os_version_info;
 
 //Maps marketing names to the actual Windows NT versions
 static const struct
@@ -405,43 +390,31 @@ static bool get_real_os_version(unsigned int *const major, unsigned int *const m
 	return true;
 }
 
-const MUtils::OS::Version::os_version_t &MUtils::OS::os_version(void)
+static MUtils::OS::Version::os_version_t *detect_os_version(void)
 {
-	QReadLocker readLock(&g_os_version_lock);
-
-	//Already initialized?
-	if(g_os_version_initialized)
-	{
-		return g_os_version_info;
-	}
-	
-	readLock.unlock();
-	QWriteLocker writeLock(&g_os_version_lock);
-
-	//Initialized now?
-	if(g_os_version_initialized)
-	{
-		return g_os_version_info;
-	}
+	MUtils::OS::Version::os_version_t *const osVersionInfo = new MUtils::OS::Version::os_version_t(MUtils::OS::Version::UNKNOWN_OPSYS);
 
 	//Detect OS version
 	unsigned int major, minor, build, spack;
 	if(get_real_os_version(&major, &minor, &build, &spack))
 	{
-		g_os_version_info.type = Version::OS_WINDOWS;
-		g_os_version_info.versionMajor = major;
-		g_os_version_info.versionMinor = minor;
-		g_os_version_info.versionBuild = build;
-		g_os_version_info.versionSPack = spack;
+		osVersionInfo->type = MUtils::OS::Version::OS_WINDOWS;
+		osVersionInfo->versionMajor = major;
+		osVersionInfo->versionMinor = minor;
+		osVersionInfo->versionBuild = build;
+		osVersionInfo->versionSPack = spack;
 	}
 	else
 	{
 		qWarning("Failed to determine the operating system version!");
 	}
 
-	//Completed
-	g_os_version_initialized = true;
-	return g_os_version_info;
+	return osVersionInfo;
+}
+
+const MUtils::OS::Version::os_version_t &MUtils::OS::os_version(void)
+{
+	return *g_os_version_info.once(detect_os_version);
 }
 
 const char *MUtils::OS::os_friendly_name(const MUtils::OS::Version::os_version_t &os_version)
@@ -463,9 +436,7 @@ const char *MUtils::OS::os_friendly_name(const MUtils::OS::Version::os_version_t
 // OS ARCHITECTURE DETECTION
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool g_os_arch_initialized = false;
-static MUtils::OS::os_arch_t g_os_arch = MUtils::OS::os_arch_t(0);
-static QReadWriteLock g_os_arch_lock;
+static MUtils::Internal::Snapshot<MUtils::OS::os_arch_t> g_os_arch;
 
 static MUtils::OS::os_arch_t detect_os_arch(void)
 {
@@ -491,35 +462,20 @@ static MUtils::OS::os_arch_t detect_os_arch(void)
 
 const MUtils::OS::os_arch_t &MUtils::OS::os_architecture(void)
 {
-	QReadLocker readLock(&g_os_arch_lock);
-
-	//Already initialized?
-	if (g_os_arch_initialized)
-	{
-		return g_os_arch;
-	}
-
-	readLock.unlock();
-	QWriteLocker writeLock(&g_os_arch_lock);
-
-	//Initialized now?
-	if (g_os_arch_initialized)
+	static const os_arch_t ARCH_UNKNOWN = os_arch_t(0);
+	const os_arch_t *const arch = g_os_arch.once([]() -> os_arch_t*
 	{
-		return g_os_arch;
-	}
-
-	g_os_arch = detect_os_arch();
-	g_os_arch_initialized = MUTILS_BOOLIFY(g_os_arch);
-	return g_os_arch;
+		const os_arch_t detected = detect_os_arch();
+		return detected ? new os_arch_t(detected) : NULL;
+	});
+	return arch ? (*arch) : ARCH_UNKNOWN;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // WINE DETECTION
 ///////////////////////////////////////////////////////////////////////////////
 
-static bool g_wine_deteced = false;
-static bool g_wine_initialized = false;
-static QReadWriteLock g_wine_lock;
+static MUtils::Internal::Snapshot<bool> g_wine_deteced;
 
 static const bool detect_wine(void)
 {
@@ -529,36 +485,14 @@ static const bool detect_wine(void)
 
 const bool &MUtils::OS::running_on_wine(void)
 {
-	QReadLocker readLock(&g_wine_lock);
-
-	//Already initialized?
-	if(g_wine_initialized)
-	{
-		return g_wine_deteced;
-	}
-
-	readLock.unlock();
-	QWriteLocker writeLock(&g_wine_lock);
-
-	//Initialized now?
-	if(g_wine_initialized)
-	{
-		return g_wine_deteced;
-	}
-
-	//Try to detect Wine
-	g_wine_deteced = detect_wine();
-	g_wine_initialized = true;
-
-	return g_wine_deteced;
+	return *g_wine_deteced.once([]() { return new bool(detect_wine()); });
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 // KNWON FOLDERS
 ///////////////////////////////////////////////////////////////////////////////
 
-static QReadWriteLock                         g_known_folders_lock;
-static QScopedPointer<QHash<size_t, QString>> g_known_folders_data;
+static MUtils::Internal::Snapshot<QHash<size_t, QString>> g_known_folders_data;
 
 typedef HRESULT (WINAPI *SHGetKnownFolderPathProc)(const GUID &rfid, DWORD dwFlags, HANDLE hToken, PWSTR *ppszPath);
 typedef HRESULT (WINAPI *SHGetFolderPathProc)(HWND hwndOwner, int nFolder, HANDLE hToken, DWORD dwFlags, LPWSTR pszPath);
@@ -717,45 +651,39 @@ const QString &MUtils::OS::known_folder(const known_folder_t folder_id)
 		return Internal::g_empty;
 	}
 	
-	//Obtain read lock 
-	QReadLocker readLock(&g_known_folders_lock);
-
 	//Already in cache?
-	if(!g_known_folders_data.isNull())
+	if(const QHash<size_t, QString> *const cache = g_known_folders_data.get())
 	{
-		if(g_known_folders_data->contains(folderId))
+		const QHash<size_t, QString>::const_iterator iter = cache->constFind(folderId);
+		if(iter != cache->constEnd())
 		{
-			return (*g_known_folders_data)[folderId];
+			return iter.value();
 		}
 	}
 
-	//Obtain write lock to initialize
-	readLock.unlock();
-	QWriteLocker writeLock(&g_known_folders_lock);
-
-	//Still not in cache?
-	if(!g_known_folders_data.isNull())
+	//Detect path and publish updated cache
+	const QHash<size_t, QString> *const cache = g_known_folders_data.update([folderId](QHash<size_t, QString> &data)
 	{
-		if(g_known_folders_data->contains(folderId))
+		if(data.contains(folderId))
 		{
-			return (*g_known_folders_data)[folderId];
+			return false; /*was added in the meantime*/
 		}
-	}
-
-	//Initialize on first call
-	if(g_known_folders_data.isNull())
-	{
-		g_known_folders_data.reset(new QHash<size_t, QString>());
-	}
-
-	//Detect path now!
-	const QString folderPath = known_folder_detect(folderId);
+		const QString folderPath = known_folder_detect(folderId);
+		if(folderPath.isEmpty())
+		{
+			return false;
+		}
+		data.insert(folderId, folderPath);
+		return true;
+	});
 
-	//Update cache
-	if (!folderPath.isEmpty())
+	if(cache)
 	{
-		g_known_folders_data->insert(folderId, folderPath);
-		return (*g_known_folders_data)[folderId];
+		const QHash<size_t, QString>::const_iterator iter = cache->constFind(folderId);
+		if(iter != cache->constEnd())
+		{
+			return iter.value();
+		}
 	}
 
 	return Internal::g_empty;
@@ -1135,34 +1063,22 @@ void MUtils::OS::sleep_ms(const size_t &duration)
 // EXECUTABLE CHECK
 ///////////////////////////////////////////////////////////////////////////////
 
-static int g_library_as_image_resource_supported = -1;
-static QReadWriteLock g_library_as_image_resource_supported_lock;
+static MUtils::Internal::Snapshot<bool> g_library_as_image_resource_supported;
 
 static bool library_as_image_resource_supported()
 {
-	QReadLocker readLocker(&g_library_as_image_resource_supported_lock);
-	if (g_library_as_image_resource_supported >= 0)
-	{
-		return (g_library_as_image_resource_supported > 0);
-	}
-
-	readLocker.unlock();
-	QWriteLocker writeLocker(&g_library_as_image_resource_supported_lock);
-
-	if (g_library_as_image_resource_supported < 0)
+	return *g_library_as_image_resource_supported.once([]()
 	{
-		g_library_as_image_resource_supported = 0;
 		OSVERSIONINFOEXW osvi;
 		if (rtl_get_version(&osvi))
 		{
 			if ((osvi.dwPlatformId == VER_PLATFORM_WIN32_NT) && (osvi.dwMajorVersion >= 6U))
 			{
-				g_library_as_image_resource_supported = 1;
+				return new bool(true);
 			}
 		}
-	}
-
-	return (g_library_as_image_resource_supported > 0);
+		return new bool(false);
+	});
 }
 
 bool MUtils::OS::is_executable_file(const QString &path)
@@ -1572,26 +1488,11 @@ bool MUtils::OS::reset_timer_resolution(const quint32 &interval)
 // SET FILE TIME
 ///////////////////////////////////////////////////////////////////////////////
 
-static QScopedPointer<QDateTime> s_epoch;
-static QReadWriteLock            s_epochLock;
+static MUtils::Internal::Snapshot<QDateTime> s_epoch;
 
 static const QDateTime *get_epoch(void)
 {
-	QReadLocker rdLock(&s_epochLock);
-
-	if (s_epoch.isNull())
-	{
-		rdLock.unlock();
-		QWriteLocker wrLock(&s_epochLock);
-		if (s_epoch.isNull())
-		{
-			s_epoch.reset(new QDateTime(QDate(1601, 1, 1), QTime(0, 0, 0, 0), Qt::UTC));
-		}
-		wrLock.unlock();
-		rdLock.relock();
-	}
-
-	return s_epoch.data();
+	return s_epoch.once([]() { return new QDateTime(QDate(1601, 1, 1), QTime(0, 0, 0, 0), Qt::UTC); });
 }
 
 static FILETIME *qt_time_to_file_time(FILETIME *const fileTime, const QDateTime &dateTime)
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QList>
+
+///////////////////////////////////////////////////////////////////////////////
+// Snapshot Holder
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Holds an immutable snapshot of type T, for process-wide caches that are read often, but written only a few times.
+ *
+ * Readers obtain the current snapshot by a single acquire load, without taking any locks and without writing to shared memory. Writers are serialized by a mutex; they create a *new* snapshot and publish it with a release store. The previous snapshot is retired, but it is *not* freed before the holder is destroyed, so that references obtained by readers remain valid.
+ */
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		template<typename T> class Snapshot
+		{
+		public:
+			Snapshot(void) { }
+
+			~Snapshot(void)
+			{
+				delete take();
+				while (!m_retired.isEmpty())
+				{
+					delete m_retired.takeLast();
+				}
+			}
+
+			//Return the current snapshot, or NULL if nothing was published yet
+			__forceinline const T *get(void) const
+			{
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+				return m_current.loadAcquire();
+#else
+				return m_current; /*volatile read*/
+#endif
+			}
+
+			//Return the current snapshot; the very first caller creates it by invoking the given function
+			template<class F> const T *once(F create)
+			{
+				if (const T *const value = get())
+				{
+					return value; /*fast path*/
+				}
+				QMutexLocker lock(&m_mutex);
+				if (const T *const value = get())
+				{
+					return value;
+				}
+				if (T *const value = create())
+				{
+					publish(value);
+					return value;
+				}
+				return NULL;
+			}
+
+			//Replace the current snapshot by a modified copy; the given function returns false to discard the copy
+			template<class F> const T *update(F modify)
+			{
+				QMutexLocker lock(&m_mutex);
+				const T *const current = get();
+				T *const value = current ? new T(*current) : new T();
+				if (!modify(*value))
+				{
+					delete value;
+					return current;
+				}
+				publish(value);
+				return value;
+			}
+
+			//Remove the current snapshot and return it to the caller, who takes the ownership
+			T *take(void)
+			{
+				return m_current.fetchAndStoreOrdered(NULL);
+			}
+
+			QMutex &mutex(void)
+			{
+				return m_mutex;
+			}
+
+		protected:
+			void publish(T *const value)
+			{
+				if (T *const previous = m_current.fetchAndStoreRelease(value))
+				{
+					m_retired.append(previous);
+				}
+			}
+
+		private:
+			MUTILS_NO_COPY(Snapshot)
+
+			QMutex m_mutex;
+			QAtomicPointer<T> m_current;
+			QList<T*> m_retired;
+		};
+	}
+}
@@ -0,0 +1,440 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/SortedList.h>
+#include <MUtils/Exception.h>
+
+//CRT
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+///////////////////////////////////////////////////////////////////////////////
+// TYPES
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		/*
+		 * Chunks are split when they grow beyond 2*SORTED_LOAD entries and are merged with a neighbour when they shrink below SORTED_LOAD/4 entries
+		 */
+		static const size_t SORTED_LOAD = 256U;
+
+		typedef struct
+		{
+			QByteArray key;
+			QString value;
+		}
+		sorted_entry_t;
+
+		typedef std::vector<sorted_entry_t> sorted_chunk_t;
+
+		static inline int sorted_compare(const QByteArray &key1, const QByteArray &key2)
+		{
+			const int result = memcmp(key1.constData(), key2.constData(), size_t(qMin(key1.size(), key2.size())));
+			return (result != 0) ? result : (key1.size() - key2.size());
+		}
+
+		static bool sorted_entry_less(const sorted_entry_t &entry1, const sorted_entry_t &entry2)
+		{
+			return (sorted_compare(entry1.key, entry2.key) < 0);
+		}
+
+		static bool sorted_entry_less_key(const sorted_entry_t &entry, const QByteArray &key)
+		{
+			return (sorted_compare(entry.key, key) < 0);
+		}
+
+		static bool sorted_key_less_entry(const QByteArray &key, const sorted_entry_t &entry)
+		{
+			return (sorted_compare(key, entry.key) < 0);
+		}
+	}
+
+	class NaturalSortedList_Private
+	{
+		friend class NaturalSortedList;
+
+	protected:
+		NaturalSortedList_Private(const bool bIgnoreCase) : ignoreCase(bIgnoreCase), total(0) {}
+
+		size_t findChunk(const QByteArray &key, const bool upper) const;
+		void locate(const QByteArray &key, const bool upper, size_t &chunk, size_t &pos) const;
+		void locate(const int index, size_t &chunk, size_t &pos) const;
+		int rank(const size_t chunk, const size_t pos) const;
+		void eraseAt(const size_t chunk, const size_t pos);
+		void rebuild(std::vector<Internal::sorted_entry_t> &entries);
+		void reindex(void);
+
+		const bool ignoreCase;
+		std::vector<Internal::sorted_chunk_t> chunks;
+		std::vector<int> fenwick;
+		int total;
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE FUNCTIONS
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Returns the first chunk whose *last* key is not less than (or, if "upper" is set, greater than) the given key, or the number of chunks, if there is no such chunk
+ */
+size_t MUtils::NaturalSortedList_Private::findChunk(const QByteArray &key, const bool upper) const
+{
+	size_t lo = 0, hi = chunks.size();
+	while (lo < hi)
+	{
+		const size_t mid = lo + ((hi - lo) / 2U);
+		const int result = Internal::sorted_compare(chunks[mid].back().key, key);
+		if ((result < 0) || (upper && (result == 0)))
+		{
+			lo = mid + 1U;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+void MUtils::NaturalSortedList_Private::locate(const QByteArray &key, const bool upper, size_t &chunk, size_t &pos) const
+{
+	chunk = findChunk(key, upper);
+	if (chunk >= chunks.size())
+	{
+		pos = 0;
+		return;
+	}
+	const Internal::sorted_chunk_t &entries = chunks[chunk];
+	pos = upper
+		? size_t(std::upper_bound(entries.begin(), entries.end(), key, Internal::sorted_key_less_entry) - entries.begin())
+		: size_t(std::lower_bound(entries.begin(), entries.end(), key, Internal::sorted_entry_less_key) - entries.begin());
+}
+
+/*
+ * Fenwick tree search: finds the chunk that contains the entry at the given index
+ */
+void MUtils::NaturalSortedList_Private::locate(const int index, size_t &chunk, size_t &pos) const
+{
+	size_t node = 0, step = 1;
+	int remaining = index;
+	while ((step << 1) <= fenwick.size())
+	{
+		step <<= 1;
+	}
+	for (; step > 0; step >>= 1)
+	{
+		if ((node + step <= fenwick.size()) && (fenwick[node + step - 1] <= remaining))
+		{
+			node += step;
+			remaining -= fenwick[node - 1];
+		}
+	}
+	chunk = node;
+	pos = size_t(remaining);
+}
+
+int MUtils::NaturalSortedList_Private::rank(const size_t chunk, const size_t pos) const
+{
+	int result = int(pos);
+	for (size_t node = chunk; node > 0; node &= (node - 1))
+	{
+		result += fenwick[node - 1];
+	}
+	return result;
+}
+
+void MUtils::NaturalSortedList_Private::reindex(void)
+{
+	const size_t count = chunks.size();
+	fenwick.resize(count);
+	for (size_t i = 0; i < count; ++i)
+	{
+		fenwick[i] = int(chunks[i].size());
+	}
+	for (size_t i = 1; i <= count; ++i)
+	{
+		const size_t parent = i + (i & (0 - i));
+		if (parent <= count)
+		{
+			fenwick[parent - 1] += fenwick[i - 1];
+		}
+	}
+}
+
+void MUtils::NaturalSortedList_Private::eraseAt(const size_t chunk, const size_t pos)
+{
+	Internal::sorted_chunk_t &entries = chunks[chunk];
+	entries.erase(entries.begin() + pos);
+	--total;
+
+	if ((entries.size() >= (Internal::SORTED_LOAD / 4U)) || (chunks.size() < 2))
+	{
+		if (entries.empty())
+		{
+			chunks.clear();
+			fenwick.clear();
+			return;
+		}
+		for (size_t node = chunk + 1U; node <= fenwick.size(); node += (node & (0 - node)))
+		{
+			fenwick[node - 1] -= 1;
+		}
+		return;
+	}
+
+	//Merge with a neighbour, then split again, if the result has become too large
+	const size_t target = (chunk > 0) ? (chunk - 1U) : 0U, source = target + 1U;
+	Internal::sorted_chunk_t &merged = chunks[target];
+	merged.insert(merged.end(), chunks[source].begin(), chunks[source].end());
+	chunks.erase(chunks.begin() + source);
+	if (chunks[target].size() > (2U * Internal::SORTED_LOAD))
+	{
+		Internal::sorted_chunk_t &full = chunks[target];
+		const size_t half = full.size() / 2U;
+		Internal::sorted_chunk_t tail(full.begin() + half, full.end());
+		full.resize(half);
+		chunks.insert(chunks.begin() + target + 1U, tail);
+	}
+	reindex();
+}
+
+void MUtils::NaturalSortedList_Private::rebuild(std::vector<Internal::sorted_entry_t> &entries)
+{
+	chunks.clear();
+	for (size_t offset = 0; offset < entries.size(); offset += Internal::SORTED_LOAD)
+	{
+		const size_t end = qMin(offset + Internal::SORTED_LOAD, entries.size());
+		chunks.push_back(Internal::sorted_chunk_t(entries.begin() + offset, entries.begin() + end));
+	}
+	total = int(entries.size());
+	reindex();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::NaturalSortedList::NaturalSortedList(const bool bIgnoreCase)
+:
+	p(new NaturalSortedList_Private(bIgnoreCase))
+{
+}
+
+MUtils::NaturalSortedList::~NaturalSortedList(void)
+{
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PUBLIC FUNCTIONS
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::NaturalSortedList::insert(const QString &str)
+{
+	Internal::sorted_entry_t entry;
+	entry.key = natural_sort_key(str, p->ignoreCase);
+	entry.value = str;
+
+	if (p->chunks.empty())
+	{
+		p->chunks.push_back(Internal::sorted_chunk_t(1U, entry));
+		p->fenwick.assign(1U, 1);
+		p->total = 1;
+		return 0;
+	}
+
+	size_t chunk, pos;
+	p->locate(entry.key, true, chunk, pos);
+	if (chunk >= p->chunks.size())
+	{
+		chunk = p->chunks.size() - 1U;
+		pos = p->chunks[chunk].size();
+	}
+
+	Internal::sorted_chunk_t &entries = p->chunks[chunk];
+	entries.insert(entries.begin() + pos, entry);
+	++p->total;
+	const int index = p->rank(chunk, pos);
+
+	if (entries.size() > (2U * Internal::SORTED_LOAD))
+	{
+		const size_t half = entries.size() / 2U;
+		Internal::sorted_chunk_t tail(entries.begin() + half, entries.end());
+		entries.resize(half);
+		p->chunks.insert(p->chunks.begin() + chunk + 1U, tail);
+		p->reindex();
+	}
+	else
+	{
+		for (size_t node = chunk + 1U; node <= p->fenwick.size(); node += (node & (0 - node)))
+		{
+			p->fenwick[node - 1] += 1;
+		}
+	}
+
+	return index;
+}
+
+void MUtils::NaturalSortedList::insert(const QStringList &list)
+{
+	if ((list.count() < 64) || (list.count() < (p->total / 8)))
+	{
+		for (QStringList::ConstIterator iter = list.constBegin(); iter != list.constEnd(); ++iter)
+		{
+			insert(*iter);
+		}
+		return;
+	}
+
+	std::vector<Internal::sorted_entry_t> entries;
+	entries.reserve(size_t(p->total) + size_t(list.count()));
+	for (std::vector<Internal::sorted_chunk_t>::const_iterator iter = p->chunks.begin(); iter != p->chunks.end(); ++iter)
+	{
+		entries.insert(entries.end(), iter->begin(), iter->end());
+	}
+
+	const size_t middle = entries.size();
+	for (QStringList::ConstIterator iter = list.constBegin(); iter != list.constEnd(); ++iter)
+	{
+		Internal::sorted_entry_t entry;
+		entry.key = natural_sort_key(*iter, p->ignoreCase);
+		entry.value = *iter;
+		entries.push_back(entry);
+	}
+
+	std::stable_sort(entries.begin() + middle, entries.end(), Internal::sorted_entry_less);
+	std::inplace_merge(entries.begin(), entries.begin() + middle, entries.end(), Internal::sorted_entry_less);
+	p->rebuild(entries);
+}
+
+bool MUtils::NaturalSortedList::remove(const QString &str)
+{
+	size_t chunk, pos;
+	const QByteArray key = natural_sort_key(str, p->ignoreCase);
+	p->locate(key, false, chunk, pos);
+	if ((chunk < p->chunks.size()) && (Internal::sorted_compare(p->chunks[chunk][pos].key, key) == 0))
+	{
+		p->eraseAt(chunk, pos);
+		return true;
+	}
+	return false;
+}
+
+void MUtils::NaturalSortedList::removeAt(const int index)
+{
+	if ((index < 0) || (index >= p->total))
+	{
+		MUTILS_THROW("Index is out of range!");
+	}
+
+	size_t chunk, pos;
+	p->locate(index, chunk, pos);
+	p->eraseAt(chunk, pos);
+}
+
+void MUtils::NaturalSortedList::clear(void)
+{
+	p->chunks.clear();
+	p->fenwick.clear();
+	p->total = 0;
+}
+
+int MUtils::NaturalSortedList::count(void) const
+{
+	return p->total;
+}
+
+const QString &MUtils::NaturalSortedList::at(const int index) const
+{
+	if ((index < 0) || (index >= p->total))
+	{
+		MUTILS_THROW("Index is out of range!");
+	}
+
+	size_t chunk, pos;
+	p->locate(index, chunk, pos);
+	return p->chunks[chunk][pos].value;
+}
+
+int MUtils::NaturalSortedList::indexOf(const QString &str) const
+{
+	size_t chunk, pos;
+	const QByteArray key = natural_sort_key(str, p->ignoreCase);
+	p->locate(key, false, chunk, pos);
+	if ((chunk < p->chunks.size()) && (Internal::sorted_compare(p->chunks[chunk][pos].key, key) == 0))
+	{
+		return p->rank(chunk, pos);
+	}
+	return -1;
+}
+
+int MUtils::NaturalSortedList::lowerBound(const QString &str) const
+{
+	size_t chunk, pos;
+	p->locate(natural_sort_key(str, p->ignoreCase), false, chunk, pos);
+	return (chunk < p->chunks.size()) ? p->rank(chunk, pos) : p->total;
+}
+
+int MUtils::NaturalSortedList::upperBound(const QString &str) const
+{
+	size_t chunk, pos;
+	p->locate(natural_sort_key(str, p->ignoreCase), true, chunk, pos);
+	return (chunk < p->chunks.size()) ? p->rank(chunk, pos) : p->total;
+}
+
+QStringList MUtils::NaturalSortedList::range(const int first, const int last) const
+{
+	if ((first < 0) || (last < first) || (last > p->total))
+	{
+		MUTILS_THROW("Range is out of bounds!");
+	}
+
+	QStringList result;
+	if (first >= last)
+	{
+		return result;
+	}
+
+	size_t chunk, pos;
+	p->locate(first, chunk, pos);
+	result.reserve(last - first);
+	for (int remaining = last - first; remaining > 0; pos = 0, ++chunk)
+	{
+		const Internal::sorted_chunk_t &entries = p->chunks[chunk];
+		for (; (pos < entries.size()) && (remaining > 0); ++pos, --remaining)
+		{
+			result << entries[pos].value;
+		}
+	}
+	return result;
+}
+
+QStringList MUtils::NaturalSortedList::range(const QString &lower, const QString &upper) const
+{
+	const int first = lowerBound(lower);
+	return range(first, qMax(first, lowerBound(upper)));
+}
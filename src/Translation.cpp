@@ -22,9 +22,12 @@
 //MUtils
 #include <MUtils/Translation.h>
 
+//Internal
+#include "Snapshot.h"
+
 //Qt
 #include <QPair>
-#include <QReadWriteLock>
+#include <QMutex>
 #include <QMap>
 #include <QStringList>
 #include <QTranslator>
@@ -48,9 +51,9 @@ typedef QMap<QString, translation_entry_t>            translation_store_t;
 // TRANSLATIONS STORE
 //////////////////////////////////////////////////////////////////////////////////
 
-static QReadWriteLock                      g_translation_lock;
-static QScopedPointer<translation_store_t> g_translation_data;
-static QScopedPointer<QTranslator>         g_translation_inst;
+static MUtils::Internal::Snapshot<translation_store_t> g_translation_data;
+static QMutex                                          g_translation_lock;
+static QScopedPointer<QTranslator>                     g_translation_inst;
 
 //////////////////////////////////////////////////////////////////////////////////
 // CONSTANT
@@ -70,25 +73,22 @@ namespace MUtils
 
 bool MUtils::Translation::insert(const QString &langId, const QString &qmFile, const QString &langName, const quint32 &systemId, const quint32 &country)
 {
-	QWriteLocker writeLockTranslations(&g_translation_lock);
-
 	const QString key = langId.simplified().toLower();
 	if(key.isEmpty() || qmFile.isEmpty() || langName.isEmpty() || (systemId < 1))
 	{
 		return false;
 	}
 
-	if(g_translation_data.isNull())
+	g_translation_data.update([&](translation_store_t &data)
 	{
-		g_translation_data.reset(new translation_store_t());
-	}
-
-	if(g_translation_data->contains(key))
-	{
-		qWarning("Translation store already contains entry for '%s', going to replace!", MUTILS_UTF8(key));
-	}
+		if(data.contains(key))
+		{
+			qWarning("Translation store already contains entry for '%s', going to replace!", MUTILS_UTF8(key));
+		}
+		data.insert(key, MAKE_ENTRY(langName, qmFile, systemId, country));
+		return true;
+	});
 
-	g_translation_data->insert(key, MAKE_ENTRY(langName, qmFile, systemId, country));
 	return true;
 }
 
@@ -98,54 +98,51 @@ bool MUtils::Translation::insert(const QString &langId, const QString &qmFile, c
 
 int MUtils::Translation::enumerate(QStringList &list)
 {
-	QReadLocker readLockTranslations(&g_translation_lock);
-
-	if(g_translation_data.isNull())
+	const translation_store_t *const data = g_translation_data.get();
+	if(!data)
 	{
 		list.clear();
 		return -1;
 	}
 
-	list = g_translation_data->keys();
+	list = data->keys();
 	return list.count();
 }
 
 QString MUtils::Translation::get_name(const QString &langId)
 {
-	QReadLocker readLockTranslations(&g_translation_lock);
-
 	const QString key = langId.simplified().toLower();
-	if(key.isEmpty() || g_translation_data.isNull() || (!g_translation_data->contains(key)))
+	const translation_store_t *const data = g_translation_data.get();
+	if(key.isEmpty() || (!data) || (!data->contains(key)))
 	{
 		return QString();
 	}
 
-	return (*g_translation_data)[key].first.first;
+	return data->value(key).first.first;
 }
 
 quint32 MUtils::Translation::get_sysid(const QString &langId)
 {
-	QReadLocker readLockTranslations(&g_translation_lock);
-
 	const QString key = langId.simplified().toLower();
-	if(key.isEmpty() || g_translation_data.isNull() || (!g_translation_data->contains(key)))
+	const translation_store_t *const data = g_translation_data.get();
+	if(key.isEmpty() || (!data) || (!data->contains(key)))
 	{
 		return 0;
 	}
 
-	return (*g_translation_data)[key].second.first;
+	return data->value(key).second.first;
 }
 
 quint32 MUtils::Translation::get_country(const QString &langId)
 {
-	QReadLocker readLockTranslations(&g_translation_lock);
 	const QString key = langId.simplified().toLower();
-	if(key.isEmpty() || g_translation_data.isNull() || (!g_translation_data->contains(key)))
+	const translation_store_t *const data = g_translation_data.get();
+	if(key.isEmpty() || (!data) || (!data->contains(key)))
 	{
 		return 0;
 	}
 
-	return (*g_translation_data)[key].second.second;
+	return data->value(key).second.second;
 }
 
 //////////////////////////////////////////////////////////////////////////////////
@@ -154,22 +151,20 @@ quint32 MUtils::Translation::get_country(const QString &langId)
 
 bool MUtils::Translation::install_translator(const QString &langId)
 {
-	QReadLocker readLockTranslations(&g_translation_lock);
-
 	const QString key = langId.simplified().toLower();
-	if(key.isEmpty() || g_translation_data.isNull() || (!g_translation_data->contains(key)))
+	const translation_store_t *const data = g_translation_data.get();
+	if(key.isEmpty() || (!data) || (!data->contains(key)))
 	{
 		return false;
 	}
 
-	const QString qmFile = (*g_translation_data)[key].first.second;
-	readLockTranslations.unlock();
+	const QString qmFile = data->value(key).first.second;
 	return install_translator_from_file(qmFile);
 }
 
 bool MUtils::Translation::install_translator_from_file(const QString &qmFile)
 {
-	QWriteLocker writeLock(&g_translation_lock);
+	QMutexLocker lock(&g_translation_lock);
 
 	if(g_translation_inst.isNull())
 	{
@@ -0,0 +1,599 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/WorkerFarm.h>
+#include <MUtils/IPCChannel.h>
+#include <MUtils/IPCPayload.h>
+#include <MUtils/JobObject.h>
+#include <MUtils/OSSupport.h>
+#include <MUtils/Exception.h>
+
+//Qt
+#include <QProcess>
+#include <QThread>
+#include <QDir>
+#include <QHash>
+#include <QVector>
+
+//Win32 API
+#ifndef _INC_WINDOWS
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif //_INC_WINDOWS
+
+//CRT
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTANTS
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Protocol: the master sends CMD_JOB (job id, input) or CMD_STOP through the "jobs" channel; each worker announces a job with CMD_TAKEN (worker index, job id) *before* processing it and returns CMD_DONE (worker index, job id, success, output) through the "results" channel
+ */
+static const quint32 CMD_JOB   = 1;
+static const quint32 CMD_STOP  = 2;
+static const quint32 CMD_TAKEN = 3;
+static const quint32 CMD_DONE  = 4;
+
+static const quint32 POLL_INTERVAL = 250;
+static const quint32 STOP_TIMEOUT  = 5000;
+static const quint32 ACK_TIMEOUT   = 5000;
+
+static const char *const ARG_WORKER = "mutils-worker";
+static const char *const ARG_INDEX  = "mutils-worker-index";
+
+static inline QString CHANNEL_ID(const QString &farmId, const char *const name)
+{
+	return QString("%1_%2").arg(farmId, QLatin1String(name));
+}
+
+static inline MUtils::IPCPayload JOB_PAYLOAD(const quint32 jobId, const QByteArray &input)
+{
+	MUtils::IPCPayload payload;
+	payload.putInt(jobId);
+	payload.putBytes(input);
+	return payload;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class WorkerFarm_Private
+	{
+		friend class WorkerFarm;
+
+	protected:
+		WorkerFarm_Private(void) : nextJobId(0), running(false) {}
+
+		bool spawn(const int index);
+		bool isDead(const int index) const;
+		void handle(const quint32 command, IPCPayload &payload);
+		void drain(void);
+		bool send(const quint32 command, const IPCPayload &payload, const quint32 timeout);
+		bool dispatch(const quint32 jobId, const IPCPayload &payload);
+		void retry(const quint32 jobId);
+		void recover(void);
+
+		QString applicationId;
+		quint32 appVersionNo;
+		int workerCount;
+		QStringList arguments;
+		QString farmId;
+		QString program;
+
+		QScopedPointer<IPCChannel> jobs;
+		QScopedPointer<IPCChannel> results;
+		QScopedPointer<JobObject> jobObject;
+		QVector<QProcess*> workers;
+		QVector<quint32> current;
+		QVector<DWORD> idleSince;
+		QHash<quint32, QByteArray> inputs;
+		QHash<quint32, quint32> retries;
+		QHash<quint32, DWORD> unacked;
+		QList<WorkerFarm::farm_result_t> completed;
+		quint32 nextJobId;
+		bool running;
+	};
+}
+
+bool MUtils::WorkerFarm_Private::spawn(const int index)
+{
+	QProcess *const process = new QProcess();
+	init_process(*process, QDir::currentPath(), false);
+	process->setProcessChannelMode(QProcess::ForwardedChannels);
+
+	QStringList args;
+	args << QString("--%1=%2").arg(QLatin1String(ARG_WORKER), farmId);
+	args << QString("--%1=%2").arg(QLatin1String(ARG_INDEX), QString::number(index));
+	args << arguments;
+
+	process->start(program, args);
+	if(!process->waitForStarted())
+	{
+		qWarning("Failed to start worker process #%d!", index);
+		delete process;
+		return false;
+	}
+
+	if(!jobObject->addProcessToJob(process))
+	{
+		qWarning("Failed to add worker process #%d to the job object!", index);
+	}
+
+	delete workers[index];
+	workers[index] = process;
+	current[index] = 0;
+	idleSince[index] = GetTickCount();
+	return true;
+}
+
+/*
+ * QProcess updates its state only when events are processed, so the process handle is checked directly
+ */
+bool MUtils::WorkerFarm_Private::isDead(const int index) const
+{
+	const QProcess *const process = workers[index];
+	if(!process)
+	{
+		return true;
+	}
+	const Q_PID pid = process->pid();
+	return (!pid) || (WaitForSingleObject(pid->hProcess, 0) != WAIT_TIMEOUT);
+}
+
+void MUtils::WorkerFarm_Private::handle(const quint32 command, IPCPayload &payload)
+{
+	qint64 index, jobId;
+	if((!payload.getInt(index)) || (!payload.getInt(jobId)) || (index < 0) || (index >= qint64(workers.count())))
+	{
+		qWarning("Malformed message received from worker process, will be ignored!");
+		return;
+	}
+
+	if(command == CMD_TAKEN)
+	{
+		current[int(index)] = quint32(jobId);
+		unacked.remove(quint32(jobId));
+		return;
+	}
+
+	if(command == CMD_DONE)
+	{
+		current[int(index)] = 0;
+		idleSince[int(index)] = GetTickCount();
+		unacked.remove(quint32(jobId));
+		if(inputs.remove(quint32(jobId)) > 0)
+		{
+			qint64 success = 0;
+			WorkerFarm::farm_result_t result;
+			result.jobId = quint32(jobId);
+			result.success = payload.getInt(success) && (success != 0) && payload.getBytes(result.output);
+			completed.append(result);
+			retries.remove(quint32(jobId));
+		}
+	}
+}
+
+void MUtils::WorkerFarm_Private::drain(void)
+{
+	quint32 command, flags;
+	IPCPayload payload;
+	while(results->readPayload(command, flags, payload, 0U))
+	{
+		handle(command, payload);
+	}
+}
+
+/*
+ * While the job queue is full, the results are drained, because the workers may be blocked on a full result queue themselves. Oversized jobs have been rejected by submit(), so a failed send is always a timeout.
+ */
+bool MUtils::WorkerFarm_Private::send(const quint32 command, const IPCPayload &payload, const quint32 timeout)
+{
+	const DWORD startTime = GetTickCount();
+	forever
+	{
+		const DWORD elapsed = GetTickCount() - startTime;
+		if((timeout != WorkerFarm::INFINITE_TIMEOUT) && (elapsed >= timeout))
+		{
+			return false;
+		}
+		const quint32 waitTime = (timeout != WorkerFarm::INFINITE_TIMEOUT) ? qMin(POLL_INTERVAL, quint32(timeout - elapsed)) : POLL_INTERVAL;
+		if(jobs->sendPayload(command, 0, payload, waitTime))
+		{
+			return true;
+		}
+		drain();
+		bool alive = false;
+		for(int i = 0; (i < workers.count()) && (!alive); i++)
+		{
+			alive = !isDead(i);
+		}
+		if(!alive)
+		{
+			qWarning("The job queue is full, but no worker process is running!");
+			return false;
+		}
+	}
+}
+
+bool MUtils::WorkerFarm_Private::dispatch(const quint32 jobId, const IPCPayload &payload)
+{
+	if(!send(CMD_JOB, payload, WorkerFarm::INFINITE_TIMEOUT))
+	{
+		return false;
+	}
+	unacked.insert(jobId, GetTickCount());
+	return true;
+}
+
+void MUtils::WorkerFarm_Private::retry(const quint32 jobId)
+{
+	if(!inputs.contains(jobId))
+	{
+		unacked.remove(jobId);
+		return;
+	}
+	if(++retries[jobId] > WorkerFarm::MAX_RETRIES)
+	{
+		WorkerFarm::farm_result_t failed;
+		failed.jobId = jobId;
+		failed.success = false;
+		completed.append(failed);
+		inputs.remove(jobId);
+		retries.remove(jobId);
+		unacked.remove(jobId);
+	}
+	else if(!dispatch(jobId, JOB_PAYLOAD(jobId, inputs.value(jobId))))
+	{
+		qWarning("Failed to hand out job #%u again!", jobId);
+	}
+}
+
+/*
+ * A worker that terminates after reading a job, but before announcing it with CMD_TAKEN, loses that job. A job is considered lost, if it has not been announced in time, even though a worker has been idle all the while.
+ */
+void MUtils::WorkerFarm_Private::recover(void)
+{
+	if(unacked.isEmpty())
+	{
+		return;
+	}
+
+	const DWORD now = GetTickCount();
+	bool idle = false;
+	for(int i = 0; (i < workers.count()) && (!idle); i++)
+	{
+		idle = (!current[i]) && ((now - idleSince[i]) >= ACK_TIMEOUT);
+	}
+	if(!idle)
+	{
+		return;
+	}
+
+	const QList<quint32> jobIds = unacked.keys();
+	for(QList<quint32>::ConstIterator iter = jobIds.constBegin(); iter != jobIds.constEnd(); iter++)
+	{
+		if(unacked.contains(*iter) && ((now - unacked.value(*iter)) >= ACK_TIMEOUT))
+		{
+			qWarning("Job #%u has not been picked up in time, handing it out again!", *iter);
+			retry(*iter);
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::WorkerFarm::WorkerFarm(const QString &applicationId, const quint32 &appVersionNo, const quint32 &workerCount, const QStringList &arguments)
+:
+	p(new WorkerFarm_Private())
+{
+	p->applicationId = applicationId;
+	p->appVersionNo = appVersionNo;
+	p->workerCount = (workerCount > 0) ? int(qMin(workerCount, 64U)) : qMax(1, QThread::idealThreadCount());
+	p->arguments = arguments;
+}
+
+MUtils::WorkerFarm::~WorkerFarm(void)
+{
+	stop();
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// START & STOP
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::WorkerFarm::start(void)
+{
+	if(p->running)
+	{
+		MUTILS_THROW("Worker farm is already running!");
+	}
+
+	wchar_t program[MAX_PATH + 1];
+	const DWORD length = GetModuleFileNameW(NULL, program, MAX_PATH + 1);
+	if((length < 1) || (length > MAX_PATH))
+	{
+		qWarning("Failed to determine the path of the executable file!");
+		return false;
+	}
+
+	p->program = MUTILS_QSTR(program);
+	p->farmId = QString("farm_%1").arg(next_rand_str());
+	p->jobs.reset(new IPCChannel(p->applicationId, p->appVersionNo, CHANNEL_ID(p->farmId, "jobs"), IPCChannel::MODE_RING));
+	p->results.reset(new IPCChannel(p->applicationId, p->appVersionNo, CHANNEL_ID(p->farmId, "results"), IPCChannel::MODE_RING));
+
+	if((p->jobs->initialize() != IPCChannel::RET_SUCCESS_MASTER) || (p->results->initialize() != IPCChannel::RET_SUCCESS_MASTER))
+	{
+		qWarning("Failed to create the job queue of the worker farm!");
+		return false;
+	}
+
+	p->jobObject.reset(new JobObject());
+	p->workers.fill(NULL, p->workerCount);
+	p->current.fill(0, p->workerCount);
+	p->idleSince.fill(0, p->workerCount);
+	p->running = true;
+
+	for(int i = 0; i < p->workerCount; i++)
+	{
+		if(!p->spawn(i))
+		{
+			stop();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void MUtils::WorkerFarm::stop(void)
+{
+	if(!p->running)
+	{
+		return;
+	}
+
+	const DWORD startTime = GetTickCount();
+	for(int i = 0; i < p->workers.count(); i++)
+	{
+		const DWORD elapsed = GetTickCount() - startTime;
+		if((elapsed >= STOP_TIMEOUT) || (!p->send(CMD_STOP, IPCPayload(), STOP_TIMEOUT - elapsed)))
+		{
+			break; /*the remaining workers will be terminated*/
+		}
+	}
+
+	for(QVector<QProcess*>::Iterator iter = p->workers.begin(); iter != p->workers.end(); iter++)
+	{
+		if(*iter)
+		{
+			const DWORD elapsed = GetTickCount() - startTime;
+			if(!(*iter)->waitForFinished((elapsed < STOP_TIMEOUT) ? int(STOP_TIMEOUT - elapsed) : 1))
+			{
+				(*iter)->kill();
+				(*iter)->waitForFinished(-1);
+			}
+			delete (*iter);
+			*iter = NULL;
+		}
+	}
+
+	p->jobObject.reset();
+	p->jobs.reset();
+	p->results.reset();
+	p->workers.clear();
+	p->current.clear();
+	p->idleSince.clear();
+	p->inputs.clear();
+	p->retries.clear();
+	p->unacked.clear();
+	p->completed.clear();
+	p->running = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SUBMIT & COLLECT
+///////////////////////////////////////////////////////////////////////////////
+
+quint32 MUtils::WorkerFarm::submit(const QByteArray &input)
+{
+	if(!p->running)
+	{
+		MUTILS_THROW("Worker farm is not running!");
+	}
+
+	const quint32 jobId = (p->nextJobId + 1U) ? (p->nextJobId + 1U) : 1U; /*zero is reserved*/
+	const IPCPayload payload(JOB_PAYLOAD(jobId, input));
+	if(quint32(payload.data().size()) > p->jobs->maxPayloadSize())
+	{
+		qWarning("Job input exceeds the maximum size of %u bytes!", p->jobs->maxPayloadSize());
+		return 0;
+	}
+
+	p->nextJobId = jobId;
+	p->inputs.insert(jobId, input);
+	if(!p->dispatch(jobId, payload))
+	{
+		p->inputs.remove(jobId);
+		return 0;
+	}
+
+	return jobId;
+}
+
+/*
+ * Dead workers are detected *before* the results are drained, so every message a dead worker has sent is known before its job is handed out again
+ */
+bool MUtils::WorkerFarm::collect(farm_result_t &result, const quint32 &timeout)
+{
+	if(!p->running)
+	{
+		MUTILS_THROW("Worker farm is not running!");
+	}
+
+	const DWORD startTime = GetTickCount();
+	forever
+	{
+		QVector<int> dead;
+		for(int i = 0; i < p->workers.count(); i++)
+		{
+			if(p->isDead(i))
+			{
+				dead.append(i);
+			}
+		}
+
+		p->drain();
+
+		for(QVector<int>::ConstIterator iter = dead.constBegin(); iter != dead.constEnd(); iter++)
+		{
+			const quint32 jobId = p->current[*iter];
+			qWarning("Worker process #%d has terminated unexpectedly, restarting!", *iter);
+			if(!p->spawn(*iter))
+			{
+				qWarning("Failed to restart worker process #%d!", *iter);
+				return false;
+			}
+			if(jobId)
+			{
+				p->retry(jobId);
+			}
+		}
+
+		p->recover();
+
+		if(!p->completed.isEmpty())
+		{
+			result = p->completed.takeFirst();
+			return true;
+		}
+
+		if(p->inputs.isEmpty())
+		{
+			return false; /*nothing pending*/
+		}
+
+		const DWORD elapsed = GetTickCount() - startTime;
+		if((timeout != INFINITE_TIMEOUT) && (elapsed >= timeout))
+		{
+			return false;
+		}
+
+		quint32 command, flags;
+		IPCPayload payload;
+		const quint32 waitTime = (timeout != INFINITE_TIMEOUT) ? qMin(POLL_INTERVAL, quint32(timeout - elapsed)) : POLL_INTERVAL;
+		if(p->results->readPayload(command, flags, payload, waitTime))
+		{
+			p->handle(command, payload);
+		}
+	}
+}
+
+quint32 MUtils::WorkerFarm::pending(void) const
+{
+	return quint32(p->inputs.count());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// WORKER
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::WorkerFarm::isWorker(void)
+{
+	return OS::arguments().contains(QLatin1String(ARG_WORKER));
+}
+
+/*
+ * The worker does not need to watch the master: all workers belong to the master's job object, so they are terminated when the master exits
+ */
+int MUtils::WorkerFarm::runWorker(const QString &applicationId, const quint32 &appVersionNo, const job_function_t function, void *const userData)
+{
+	const OS::ArgumentMap &args = OS::arguments();
+	const QString farmId = args.value(QLatin1String(ARG_WORKER));
+	bool ok = false;
+	const quint32 index = args.value(QLatin1String(ARG_INDEX)).toUInt(&ok);
+	if(farmId.isEmpty() || (!ok))
+	{
+		qWarning("Worker process was started with invalid arguments!");
+		return EXIT_FAILURE;
+	}
+
+	IPCChannel jobs(applicationId, appVersionNo, CHANNEL_ID(farmId, "jobs"), IPCChannel::MODE_RING);
+	IPCChannel results(applicationId, appVersionNo, CHANNEL_ID(farmId, "results"), IPCChannel::MODE_RING);
+	if((jobs.initialize() != IPCChannel::RET_SUCCESS_SLAVE) || (results.initialize() != IPCChannel::RET_SUCCESS_SLAVE))
+	{
+		qWarning("Failed to attach to the job queue of the worker farm!");
+		return EXIT_FAILURE;
+	}
+
+	forever
+	{
+		quint32 command, flags;
+		IPCPayload payload;
+		if(!jobs.readPayload(command, flags, payload))
+		{
+			continue;
+		}
+		if(command == CMD_STOP)
+		{
+			return EXIT_SUCCESS;
+		}
+
+		qint64 jobId;
+		QByteArray input;
+		if((command != CMD_JOB) || (!payload.getInt(jobId)) || (!payload.getBytes(input)))
+		{
+			qWarning("Malformed job received from the master process, will be ignored!");
+			continue;
+		}
+
+		IPCPayload taken;
+		taken.putInt(index);
+		taken.putInt(jobId);
+		results.sendPayload(CMD_TAKEN, 0, taken);
+
+		QByteArray output;
+		const bool success = function(input, output, userData);
+
+		IPCPayload done;
+		done.putInt(index);
+		done.putInt(jobId);
+		done.putInt(success ? 1 : 0);
+		done.putBytes(output);
+		if(!results.sendPayload(CMD_DONE, 0, done))
+		{
+			qWarning("Failed to return the result of job #%u, reporting failure!", quint32(jobId));
+			done.clear();
+			done.putInt(index);
+			done.putInt(jobId);
+			done.putInt(0);
+			results.sendPayload(CMD_DONE, 0, done);
+		}
+	}
+}
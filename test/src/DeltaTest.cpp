@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "MUtilsTest.h"
+
+//MUtils
+#include <MUtils/Delta.h>
+
+//Internal
+#include "../../src/3rd_party/adler32/include/adler32.h"
+
+//Qt
+#include <QBuffer>
+
+//===========================================================================
+// HELPER METHODS
+//===========================================================================
+
+static QByteArray makeRandomData(const int len)
+{
+	QByteArray data(len, '\0');
+	for (int i = 0; i < len; ++i)
+	{
+		data[i] = char(MUtils::next_rand_u32() & 0xFF);
+	}
+	return data;
+}
+
+//===========================================================================
+// TESTBED CLASS
+//===========================================================================
+
+class DeltaTest : public Testbed
+{
+protected:
+	virtual void SetUp()
+	{
+	}
+
+	virtual void TearDown()
+	{
+	}
+};
+
+//===========================================================================
+// TEST METHODS
+//===========================================================================
+
+#define TEST_DELTA(BASIS, TARGET, BLOCK_SIZE, MAX_SIZE) do \
+{ \
+	QByteArray basisData((BASIS)), targetData((TARGET)), signature, deltaData, outputData; \
+	{ \
+		QBuffer basis(&basisData); \
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly)); \
+		ASSERT_TRUE(MUtils::Delta::signature(basis, signature, (BLOCK_SIZE))); \
+	} \
+	{ \
+		QBuffer target(&targetData), delta(&deltaData); \
+		ASSERT_TRUE(target.open(QIODevice::ReadOnly)); \
+		ASSERT_TRUE(delta.open(QIODevice::WriteOnly)); \
+		ASSERT_TRUE(MUtils::Delta::generate(signature, target, delta)); \
+		ASSERT_LE(deltaData.size(), (MAX_SIZE)); \
+	} \
+	{ \
+		QBuffer basis(&basisData), delta(&deltaData), output(&outputData); \
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly)); \
+		ASSERT_TRUE(delta.open(QIODevice::ReadOnly)); \
+		ASSERT_TRUE(output.open(QIODevice::WriteOnly)); \
+		ASSERT_TRUE(MUtils::Delta::apply(basis, delta, output)); \
+	} \
+	ASSERT_TRUE(outputData == targetData); \
+} \
+while(0)
+
+TEST_F(DeltaTest, Identical)
+{
+	const QByteArray data = makeRandomData(1048576 + 77);
+	TEST_DELTA(data, data, 2048, 1024);
+	TEST_DELTA(QByteArray(), QByteArray(), 2048, 1024);
+}
+
+TEST_F(DeltaTest, Modified)
+{
+	const QByteArray data = makeRandomData(1048576 + 77);
+	QByteArray modified(data);
+	modified[12345] = char(modified[12345] ^ 0x55);
+	modified.insert(524288, TEST_STRING);
+	modified.remove(786432, 1000);
+	TEST_DELTA(data, modified, 2048, 16384);
+}
+
+TEST_F(DeltaTest, Unrelated)
+{
+	const QByteArray target = makeRandomData(65536);
+	TEST_DELTA(makeRandomData(65536), target, 2048, 65536 + 1024);
+	TEST_DELTA(QByteArray(), target, 2048, 65536 + 1024);
+}
+
+TEST_F(DeltaTest, Corrupted)
+{
+	QByteArray basisData(makeRandomData(65536)), targetData(basisData), signature, deltaData, outputData;
+	targetData[0] = char(targetData[0] ^ 0x01);
+	{
+		QBuffer basis(&basisData);
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(MUtils::Delta::signature(basis, signature));
+	}
+	{
+		QBuffer target(&targetData), delta(&deltaData);
+		ASSERT_TRUE(target.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(delta.open(QIODevice::WriteOnly));
+		ASSERT_TRUE(MUtils::Delta::generate(signature, target, delta));
+	}
+	basisData[65535] = char(basisData[65535] ^ 0x01);
+	{
+		QBuffer basis(&basisData), delta(&deltaData), output(&outputData);
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(delta.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+		ASSERT_FALSE(MUtils::Delta::apply(basis, delta, output));
+	}
+}
+
+TEST_F(DeltaTest, UnknownHash)
+{
+	QByteArray basisData(makeRandomData(65536)), targetData(basisData), signature, deltaData, outputData;
+	{
+		QBuffer basis(&basisData);
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(MUtils::Delta::signature(basis, signature));
+	}
+	{
+		QBuffer target(&targetData), delta(&deltaData);
+		ASSERT_TRUE(target.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(delta.open(QIODevice::WriteOnly));
+		ASSERT_TRUE(MUtils::Delta::generate(signature, target, delta));
+	}
+	signature[6] = signature[7] = deltaData[6] = deltaData[7] = char(0xFF); /*hash id follows magic and version*/
+	{
+		QByteArray dummy;
+		QBuffer target(&targetData), delta(&dummy);
+		ASSERT_TRUE(target.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(delta.open(QIODevice::WriteOnly));
+		ASSERT_FALSE(MUtils::Delta::generate(signature, target, delta));
+	}
+	{
+		QBuffer basis(&basisData), delta(&deltaData), output(&outputData);
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(delta.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+		ASSERT_FALSE(MUtils::Delta::apply(basis, delta, output));
+	}
+	{
+		QBuffer basis(&basisData);
+		ASSERT_TRUE(basis.open(QIODevice::ReadOnly));
+		ASSERT_FALSE(MUtils::Delta::signature(basis, signature, 2048, 0xFFFF));
+	}
+}
+
+#undef TEST_DELTA
+
+//-----------------------------------------------------------------
+// Adler-32
+//-----------------------------------------------------------------
+
+TEST_F(DeltaTest, Adler32Kernels)
+{
+	static const MUtils::Internal::adler32_kernel_t KERNELS[] = { MUtils::Internal::ADLER32_SSSE3, MUtils::Internal::ADLER32_AVX2 };
+	static const quint32 NMAX = 5552U;
+	const QByteArray data = makeRandomData(4 * NMAX + 256);
+	const unsigned char *const base = reinterpret_cast<const unsigned char*>(data.constData());
+
+	QList<quint32> lengths;
+	for (quint32 len = 0; len < 300; ++len)
+	{
+		lengths << len;
+	}
+	for (quint32 n = 1; n <= 3; ++n)
+	{
+		for (quint32 delta = 0; delta < 130; ++delta)
+		{
+			lengths << (n * NMAX) - 65U + delta;
+		}
+	}
+	for (int i = 0; i < 64; ++i)
+	{
+		lengths << MUtils::next_rand_u32(4 * NMAX);
+	}
+
+	for (size_t k = 0; k < sizeof(KERNELS) / sizeof(KERNELS[0]); ++k)
+	{
+		if (!MUtils::Internal::adler32_supported(KERNELS[k]))
+		{
+			continue; /*not supported by this CPU*/
+		}
+		for (QList<quint32>::ConstIterator iter = lengths.constBegin(); iter != lengths.constEnd(); ++iter)
+		{
+			const quint32 offset = MUtils::next_rand_u32(64);
+			const quint32 seed = (MUtils::next_rand_u32(65521U) << 16) | MUtils::next_rand_u32(65521U);
+			const quint32 expected = MUtils::Internal::adler32_kernel(MUtils::Internal::ADLER32_SCALAR, seed, base + offset, *iter);
+			ASSERT_EQ(MUtils::Internal::adler32_kernel(KERNELS[k], seed, base + offset, *iter), expected);
+			ASSERT_EQ(MUtils::Internal::adler32_kernel(KERNELS[k], 1U, base + offset, *iter), MUtils::Internal::adler32_kernel(MUtils::Internal::ADLER32_SCALAR, 1U, base + offset, *iter));
+		}
+	}
+
+	ASSERT_EQ(MUtils::Internal::adler32(1U, "Wikipedia", 9), quint32(0x11E60398));
+}
+
+TEST_F(DeltaTest, Adler32Combine)
+{
+	const QByteArray data = makeRandomData(65536 + 17);
+	const unsigned char *const base = reinterpret_cast<const unsigned char*>(data.constData());
+	for (int i = 0; i < 256; ++i)
+	{
+		const quint32 total = MUtils::next_rand_u32(quint32(data.size()) + 1U);
+		const quint32 split = MUtils::next_rand_u32(total + 1U);
+		const quint32 adler1 = MUtils::Internal::adler32(1U, base, split);
+		const quint32 adler2 = MUtils::Internal::adler32(1U, base + split, total - split);
+		ASSERT_EQ(MUtils::Internal::adler32_combine(adler1, adler2, total - split), MUtils::Internal::adler32(1U, base, total));
+	}
+}
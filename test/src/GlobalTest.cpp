@@ -23,9 +23,16 @@
 
 //MUtils
 #include <MUtils/OSSupport.h>
+#include <MUtils/Lazy.h>
+#include <MUtils/SortedList.h>
+
+//Internal
+#include "../../src/3rd_party/strnatcmp/include/strnatcmp.h"
 
 //Qt
 #include <QSet>
+#include <QThread>
+#include <QElapsedTimer>
 
 //===========================================================================
 // TESTBED CLASS
@@ -86,6 +93,33 @@ TEST_F(GlobalTest, RandomStr)
 	TEST_RANDOM(QString, str);
 }
 
+TEST_F(GlobalTest, RandomBytes)
+{
+	QByteArray buffer1(4099, '\0'), buffer2(4099, '\0');
+	MUtils::next_rand_bytes(buffer1.data(), buffer1.size());
+	MUtils::next_rand_bytes(buffer2.data(), buffer2.size());
+	ASSERT_NE(buffer1, buffer2);
+	ASSERT_LT(buffer1.count('\0'), 64);
+}
+
+TEST_F(GlobalTest, RandomBounded)
+{
+	static const quint32 MAX_VALUE = 7U;
+	quint32 histogram[MAX_VALUE] = { 0 };
+	for (size_t i = 0; i < 70000; ++i)
+	{
+		const quint32 value = MUtils::next_rand_u32(MAX_VALUE);
+		ASSERT_LT(value, MAX_VALUE);
+		histogram[value]++;
+	}
+	for (size_t i = 0; i < MAX_VALUE; ++i)
+	{
+		ASSERT_GT(histogram[i], 9000U);
+	}
+	ASSERT_EQ(MUtils::next_rand_u32(0U), 0U);
+	ASSERT_EQ(MUtils::next_rand_u32(1U), 0U);
+}
+
 #undef TEST_RANDOM
 #undef RND_LIMIT
 
@@ -125,6 +159,30 @@ TEST_F(GlobalTest, TrimStringRight)
 	TEST_TRIM_STR(right, "   !   test   !   ", "   !   test   !");
 }
 
+TEST_F(GlobalTest, TrimStringLong)
+{
+	TEST_TRIM_STR(left, " \t\r\n \t\r\n \t\r\n \t\r\n !test! \t\r\n", "!test! \t\r\n");
+	TEST_TRIM_STR(right, " \t\r\n !test! \t\r\n \t\r\n \t\r\n \t\r\n", " \t\r\n !test!");
+	{
+		QString test(QString(17, QChar(0x3000)) + QLatin1String("test") + QString(17, QChar(0x00A0)));
+		ASSERT_QSTR(MUtils::trim_right(MUtils::trim_left(test)), "test");
+	}
+}
+
+TEST_F(GlobalTest, TrimStringList)
+{
+	QStringList list;
+	list << QLatin1String("   foo   ") << QLatin1String("bar") << QLatin1String("") << QLatin1String("\t\tbaz");
+	const QChar *const unchanged = list.at(1).constData();
+	MUtils::trim_right(MUtils::trim_left(list));
+	ASSERT_EQ(list.count(), 4);
+	ASSERT_QSTR(list.at(0), "foo");
+	ASSERT_QSTR(list.at(1), "bar");
+	ASSERT_QSTR(list.at(2), "");
+	ASSERT_QSTR(list.at(3), "baz");
+	ASSERT_EQ(list.at(1).constData(), unchanged);
+}
+
 #undef TEST_TRIM_STR
 
 //-----------------------------------------------------------------
@@ -180,6 +238,99 @@ TEST_F(GlobalTest, CleanFilePath)
 	TEST_CLEAN_FILE(path, "c:\\example\\NULx.txt", "c:/example/NULx.txt");
 }
 
+//Reference implementation, based on regular expressions (as used before the single-pass implementation)
+static QString clean_file_name_reference(const QString &name, const bool pretty)
+{
+	static const char *const PATTERN[][2] =
+	{
+		{ "^\\s*\"([^\"]*)\"\\s*$",    "\\1"                         },
+		{ "\"([^\"]*)\"",              "\xE2\x80\x9C\\1\xE2\x80\x9D" },
+		{ "^[\\\\/:]+([^\\\\/:]+.*)$", "\\1"                         },
+		{ "^(.*[^\\\\/:]+)[\\\\/:]+$", "\\1"                         },
+		{ "(\\s*[\\\\/:]\\s*)+",       " - "                         },
+		{ NULL, NULL }
+	};
+	static const char *const RESERVED[] =
+	{
+		"CON", "PRN", "AUX", "NUL", "COM1", "COM2", "COM3", "COM4", "COM5", "COM6", "COM7", "COM8", "COM9",
+		"LPT1", "LPT2", "LPT3", "LPT4", "LPT5", "LPT6", "LPT7", "LPT8", "LPT9", NULL
+	};
+
+	QString result(name);
+	bool keepOnGoing = pretty && (!result.isEmpty());
+	while (keepOnGoing)
+	{
+		const QString prev = result;
+		keepOnGoing = false;
+		for (size_t i = 0; PATTERN[i][0]; ++i)
+		{
+			result.replace(QRegExp(QString::fromUtf8(PATTERN[i][0]), Qt::CaseInsensitive), QString::fromUtf8(PATTERN[i][1]));
+			if (result.compare(prev))
+			{
+				result = result.simplified();
+				keepOnGoing = !result.isEmpty();
+				break;
+			}
+		}
+	}
+	for (QString::Iterator iter = result.begin(); iter != result.end(); iter++)
+	{
+		if ((iter->category() == QChar::Other_Control) || (iter->unicode() && (iter->unicode() < 0x80) && strchr("<>:\"/\\|?*", iter->toLatin1())))
+		{
+			*iter = QLatin1Char('_');
+		}
+	}
+	MUtils::trim_right(result);
+	while (result.endsWith(QLatin1Char('.')))
+	{
+		result.chop(1);
+		MUtils::trim_right(result);
+	}
+	for (size_t i = 0; RESERVED[i]; i++)
+	{
+		const QString reserved = QString::fromLatin1(RESERVED[i]);
+		if ((!result.compare(reserved, Qt::CaseInsensitive)) || result.startsWith(reserved + QLatin1Char('.'), Qt::CaseInsensitive))
+		{
+			result.replace(0, reserved.length(), QString(reserved.length(), QLatin1Char('_')));
+		}
+	}
+	return result;
+}
+
+TEST_F(GlobalTest, CleanFileNameEquivalence)
+{
+	static const ushort ALPHABET[] =
+	{
+		'a', 'b', 'N', 'u', 'l', '.', '-', ' ', ' ', '\t', '\n', '"', '"', '/', '\\', ':', '<', '?', 0x01, 0xA0, 0x201C
+	};
+	static const quint32 ALPHABET_SIZE = quint32(sizeof(ALPHABET) / sizeof(ALPHABET[0]));
+	for (size_t i = 0; i < 25000; ++i)
+	{
+		QString name;
+		const quint32 length = MUtils::next_rand_u32(24U);
+		for (quint32 j = 0; j < length; ++j)
+		{
+			name += QChar(ALPHABET[MUtils::next_rand_u32(ALPHABET_SIZE)]);
+		}
+		ASSERT_EQ(MUtils::clean_file_name(name, false).compare(clean_file_name_reference(name, false)), 0) << "input: " << MUTILS_UTF8(name);
+		ASSERT_EQ(MUtils::clean_file_name(name, true).compare(clean_file_name_reference(name, true)), 0) << "input: " << MUTILS_UTF8(name);
+	}
+}
+
+TEST_F(GlobalTest, CleanFileNameList)
+{
+	QStringList names;
+	names << QLatin1String("\"foo: bar\"") << QLatin1String("example.txt") << QLatin1String("/a/ /b/") << QLatin1String("nul.txt");
+	const QChar *const unchanged = names.at(1).constData();
+	MUtils::clean_file_name(names, true);
+	ASSERT_EQ(names.count(), 4);
+	ASSERT_QSTR(names.at(0), "foo - bar");
+	ASSERT_QSTR(names.at(1), "example.txt");
+	ASSERT_QSTR(names.at(2), "a - b");
+	ASSERT_QSTR(names.at(3), "___.txt");
+	ASSERT_EQ(names.at(1).constData(), unchanged);
+}
+
 //-----------------------------------------------------------------
 // File Names
 //-----------------------------------------------------------------
@@ -321,6 +472,39 @@ TEST_F(GlobalTest, Directory)
 	}
 }
 
+TEST_F(GlobalTest, TempFile)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	QFile test;
+	ASSERT_TRUE(MUtils::make_temp_file(test, QDir(workDir), QLatin1String("tmp")));
+	ASSERT_TRUE(test.isOpen());
+	ASSERT_TRUE(test.fileName().endsWith(QLatin1String(".tmp")));
+	ASSERT_EQ(test.write("foo", 3), qint64(3));
+	test.close();
+	ASSERT_EQ(QFileInfo(test.fileName()).size(), qint64(3));
+	const QString placeholder = MUtils::make_temp_file(QDir(workDir), QLatin1String("tmp"), true);
+	ASSERT_FALSE(placeholder.isEmpty());
+	ASSERT_TRUE(QFileInfo(placeholder).exists());
+	ASSERT_FALSE(MUtils::make_temp_file(test, QDir(QString("%1/missing").arg(workDir)), QLatin1String("tmp")));
+}
+
+TEST_F(GlobalTest, TempFileBatch)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QStringList tempFiles = MUtils::make_temp_files(QDir(workDir), QLatin1String("tmp"), 1000);
+	ASSERT_EQ(tempFiles.count(), 1000);
+	QSet<QString> unique;
+	for (QStringList::ConstIterator iter = tempFiles.constBegin(); iter != tempFiles.constEnd(); ++iter)
+	{
+		ASSERT_TRUE(QFileInfo(*iter).exists());
+		unique << (*iter).toLower();
+	}
+	ASSERT_EQ(unique.count(), 1000);
+	ASSERT_TRUE(MUtils::make_temp_files(QDir(QString("%1/missing").arg(workDir)), QLatin1String("tmp"), 10).isEmpty());
+}
+
 #undef MAKE_TEST_FILE
 #undef MAKE_SUB_DIR
 
@@ -363,6 +547,102 @@ TEST_F(GlobalTest, NaturalStrSort)
 	}
 }
 
+static int natural_sort_key_compare(const QString &str1, const QString &str2, const bool bIgnoreCase)
+{
+	const QByteArray key1 = MUtils::natural_sort_key(str1, bIgnoreCase), key2 = MUtils::natural_sort_key(str2, bIgnoreCase);
+	const int result = memcmp(key1.constData(), key2.constData(), size_t(qMin(key1.size(), key2.size())));
+	return (result != 0) ? result : (key1.size() - key2.size());
+}
+
+TEST_F(GlobalTest, NaturalSortKey)
+{
+	static const char *const TEST[] =
+	{
+		"a1", "a01", "a2", "a10", "a010", "b1.05", "b1.5", "b1.50", "b1.6", "x 1", "x2", "x 10", NULL
+	};
+
+	for (size_t i = 0; TEST[i] && TEST[i + 1]; i++)
+	{
+		ASSERT_LT(natural_sort_key_compare(QLatin1String(TEST[i]), QLatin1String(TEST[i + 1]), false), 0);
+	}
+
+	ASSERT_LT(natural_sort_key_compare(QLatin1String("abc9"), QLatin1String("ABC10"), true), 0);
+	ASSERT_GT(natural_sort_key_compare(QLatin1String("abc9"), QLatin1String("ABC10"), false), 0);
+	ASSERT_NE(natural_sort_key_compare(QLatin1String("abc"), QLatin1String("ABC"), true), 0);
+}
+
+TEST_F(GlobalTest, NaturalStrSortLarge)
+{
+	static const char *const CHARS = "0123456789 .,aB";
+	QStringList test;
+	for (int i = 0; i < 100000; i++)
+	{
+		QString str;
+		for (quint32 len = MUtils::next_rand_u32(12); len > 0; --len)
+		{
+			str += QLatin1Char(CHARS[MUtils::next_rand_u32(quint32(strlen(CHARS)))]);
+		}
+		test << str;
+	}
+
+	for (int k = 0; k < 2; k++)
+	{
+		const bool bIgnoreCase = (k != 0);
+		MUtils::natural_string_sort(test, bIgnoreCase);
+		ASSERT_EQ(test.count(), 100000);
+		for (int i = 1; i < test.count(); i++)
+		{
+			const wchar_t *const str1 = MUTILS_WCHR(test[i - 1]), *const str2 = MUTILS_WCHR(test[i]);
+			ASSERT_LE(bIgnoreCase ? MUtils::Internal::NaturalSort::strnatcasecmp(str1, str2) : MUtils::Internal::NaturalSort::strnatcmp(str1, str2), 0);
+			ASSERT_LE(natural_sort_key_compare(test[i - 1], test[i], bIgnoreCase), 0);
+		}
+	}
+}
+
+TEST_F(GlobalTest, NaturalSortedList)
+{
+	MUtils::NaturalSortedList sorted(true);
+	QStringList reference;
+	for (int i = 0; i < 5000; i++)
+	{
+		const QString str = QString("File%1.txt").arg(QString::number(MUtils::next_rand_u32(2000)));
+		const int index = sorted.insert(str);
+		ASSERT_EQ(sorted.at(index), str);
+		reference << str;
+	}
+
+	MUtils::natural_string_sort(reference, true);
+	ASSERT_EQ(sorted.toList(), reference);
+
+	for (int i = 0; i < 2500; i++)
+	{
+		const int index = int(MUtils::next_rand_u32(quint32(reference.count())));
+		if (i % 2)
+		{
+			ASSERT_TRUE(sorted.remove(reference[index]));
+		}
+		else
+		{
+			sorted.removeAt(index);
+		}
+		reference.removeAt(index);
+	}
+	ASSERT_EQ(sorted.toList(), reference);
+
+	const int first = sorted.lowerBound(QLatin1String("file100.txt")), last = sorted.upperBound(QLatin1String("file999.txt"));
+	ASSERT_EQ(sorted.range(QLatin1String("file100.txt"), QLatin1String("file1000.txt")), reference.mid(first, sorted.lowerBound(QLatin1String("file1000.txt")) - first));
+	for (int i = 0; i < reference.count(); i++)
+	{
+		const bool inRange = (natural_sort_key_compare(reference[i], QLatin1String("file100.txt"), true) >= 0) && (natural_sort_key_compare(reference[i], QLatin1String("file999.txt"), true) <= 0);
+		ASSERT_EQ(inRange, (i >= first) && (i < last));
+	}
+
+	ASSERT_FALSE(sorted.contains(QLatin1String("File2001.txt")));
+	sorted.insert(reference);
+	ASSERT_EQ(sorted.count(), 2 * reference.count());
+	ASSERT_EQ(sorted.indexOf(reference.first()), 0);
+}
+
 //-----------------------------------------------------------------
 // RegExp Parser
 //-----------------------------------------------------------------
@@ -390,3 +670,66 @@ TEST_F(GlobalTest, ParseRegExp)
 }
 
 #undef TEST_REGEX_U32
+
+//-----------------------------------------------------------------
+// Lazy Initialization
+//-----------------------------------------------------------------
+
+TEST_F(GlobalTest, LazyPointer)
+{
+	int calls = 0;
+	MUtils::Lazy<QString> lazy([&calls]() { ++calls; return new QString(QLatin1String("foo")); });
+	ASSERT_FALSE(lazy.initialized());
+	ASSERT_QSTR(*lazy, "foo");
+	ASSERT_EQ(lazy->length(), 3);
+	ASSERT_TRUE(lazy.initialized());
+	ASSERT_EQ(calls, 1);
+}
+
+TEST_F(GlobalTest, LazyValue)
+{
+	int calls = 0;
+	MUtils::LazyValue<QString> lazy([&calls]() { if (++calls < 2) { throw std::runtime_error("retry"); } return QString(QLatin1String("bar")); });
+	ASSERT_ANY_THROW(*lazy);
+	ASSERT_FALSE(lazy.initialized());
+	ASSERT_QSTR(*lazy, "bar");
+	ASSERT_QSTR(*lazy, "bar");
+	ASSERT_TRUE(lazy.initialized());
+	ASSERT_EQ(calls, 2);
+}
+
+TEST_F(GlobalTest, LazyPrefetch)
+{
+	QAtomicInt calls;
+	MUtils::Lazy<QString> lazy1([&calls]() { calls.ref(); return new QString(QLatin1String("foo")); }, true);
+	MUtils::LazyValue<QString> lazy2([&calls]() { calls.ref(); return QString(QLatin1String("bar")); });
+	MUtils::LazyGroup group;
+	group.add(lazy1).add(lazy2).prefetch();
+	ASSERT_TRUE(group.wait());
+	ASSERT_TRUE(lazy1.initialized());
+	ASSERT_TRUE(lazy2.initialized());
+	ASSERT_QSTR(*lazy1, "foo");
+	ASSERT_QSTR(*lazy2, "bar");
+	ASSERT_EQ(int(calls), 2);
+}
+
+TEST_F(GlobalTest, CachedValue)
+{
+	QAtomicInt calls;
+	MUtils::Cached<int> cached([&calls]() { return calls.fetchAndAddOrdered(1) + 1; }, 3600000U);
+	ASSERT_FALSE(cached.initialized());
+	ASSERT_EQ(*cached, 1);
+	ASSERT_EQ(*cached, 1);
+	cached.invalidate();
+	ASSERT_EQ(*cached, 1); /*stale value, refresh is started*/
+	QElapsedTimer timer;
+	timer.start();
+	while ((cached.get() == 1) && (timer.elapsed() < 10000))
+	{
+		QThread::yieldCurrentThread();
+	}
+	ASSERT_EQ(*cached, 2);
+	ASSERT_EQ(cached.refresh(), 3);
+	ASSERT_EQ(*cached, 3);
+	ASSERT_EQ(int(calls), 3);
+}
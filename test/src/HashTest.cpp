@@ -117,6 +117,22 @@ while(0)
 } \
 while (0)
 
+#define TEST_HASH_RESET(ID, INPUT) do \
+{ \
+	for (int k = 0; k < 2; k++) \
+	{ \
+		QScopedPointer<MUtils::Hash::Hash> fresh(MUtils::Hash::create(MUtils::Hash::HASH_##ID, k ? SEED_KEY : NULL)); \
+		QScopedPointer<MUtils::Hash::Hash> reused(MUtils::Hash::create(MUtils::Hash::HASH_##ID, k ? SEED_KEY : NULL)); \
+		ASSERT_TRUE(fresh->update(QByteArray(INPUT))); \
+		ASSERT_TRUE(reused->update(QByteArray(TEST_MESSAGE_ALT))); \
+		reused->digest(); \
+		ASSERT_TRUE(reused->reset()); \
+		ASSERT_TRUE(reused->update(QByteArray(INPUT))); \
+		ASSERT_EQ(reused->digest(), fresh->digest()); \
+	} \
+} \
+while(0)
+
 //-----------------------------------------------------------------
 // Keccak
 //-----------------------------------------------------------------
@@ -173,6 +189,12 @@ TEST_F(HashTest, TestKeccak512FileIO)
 	TEST_HASH_FILEIO(KECCAK_512, TEST_MESSAGE_ALT, "0b46f421465ec602262e0a1044e59b36fbdb5f63f84e712963d2bc61bcb46ab0ebf86e59c14c253717ea558929c251695663226ffa5660ff7a29a5acbdaea901");
 }
 
+TEST_F(HashTest, TestKeccakReset)
+{
+	TEST_HASH_RESET(KECCAK_256, TEST_MESSAGE_ORG);
+	TEST_HASH_RESET(KECCAK_512, "");
+}
+
 TEST_F(HashTest, TestKeccak512Stress)
 {
 	QSet<QByteArray> test;
@@ -197,6 +219,12 @@ TEST_F(HashTest, TestBlake2FileIO)
 	TEST_HASH_FILEIO(BLAKE2_512, TEST_MESSAGE_ALT, "a5b8a16391f8e34e16901fc2fd5754523b0c95354c2f22d3efc327c53070504ea062e219c502561f77a4933c18d36633e5f3ecf1f11506159f4b1875abb767c1");
 }
 
+TEST_F(HashTest, TestBlake2Reset)
+{
+	TEST_HASH_RESET(BLAKE2_512, TEST_MESSAGE_ORG);
+	TEST_HASH_RESET(BLAKE2_512, "");
+}
+
 TEST_F(HashTest, TestBlake2Stress)
 {
 	QSet<QByteArray> test;
@@ -206,3 +234,4 @@ TEST_F(HashTest, TestBlake2Stress)
 
 #undef TEST_HASH_DIRECT
 #undef TEST_HASH_FILEIO
+#undef TEST_HASH_RESET
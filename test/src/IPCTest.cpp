@@ -0,0 +1,730 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "MUtilsTest.h"
+
+//MUtils
+#include <MUtils/IPCChannel.h>
+#include <MUtils/IPCNotifier.h>
+#include <MUtils/IPCStream.h>
+#include <MUtils/IPCPayload.h>
+#include <MUtils/IPCCache.h>
+#include <MUtils/WorkerFarm.h>
+
+//Qt
+#include <QStringList>
+#include <QBuffer>
+#include <QHash>
+#include <QTimer>
+#include <QCoreApplication>
+
+//Win32
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#endif
+
+//===========================================================================
+// TESTBED CLASS
+//===========================================================================
+
+class IPCTest : public Testbed
+{
+protected:
+	virtual void SetUp()
+	{
+		m_channelId = QString("test_%1").arg(MUtils::next_rand_str());
+	}
+
+	virtual void TearDown()
+	{
+	}
+
+	QString m_channelId;
+};
+
+//===========================================================================
+// TEST METHODS
+//===========================================================================
+
+#define TEST_IPC(MODE) do \
+{ \
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, (MODE)); \
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, (MODE)); \
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER); \
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE); \
+	for (quint32 i = 0; i < 1000; ++i) \
+	{ \
+		ASSERT_TRUE(slave.send(i, i ^ 0xFFFF, QStringList() << QString::number(i) << QString(TEST_STRING))); \
+		quint32 command, flags; \
+		QStringList params; \
+		ASSERT_TRUE(master.read(command, flags, params)); \
+		ASSERT_EQ(command, i); \
+		ASSERT_EQ(flags, i ^ 0xFFFF); \
+		ASSERT_EQ(params.count(), 2); \
+		ASSERT_EQ(params[0].toUInt(), i); \
+		ASSERT_QSTR(params[1], TEST_STRING); \
+	} \
+} \
+while(0)
+
+TEST_F(IPCTest, SemaphoreMode)
+{
+	TEST_IPC(MUtils::IPCChannel::MODE_SEMAPHORE);
+}
+
+TEST_F(IPCTest, RingMode)
+{
+	TEST_IPC(MUtils::IPCChannel::MODE_RING);
+}
+
+TEST_F(IPCTest, RingModeQueued)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	for (quint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_TRUE(slave.send(i, 0, QStringList() << QString::number(i)));
+	}
+	for (quint32 i = 0; i < 100; ++i)
+	{
+		quint32 command, flags;
+		QStringList params;
+		ASSERT_TRUE(master.read(command, flags, params));
+		ASSERT_EQ(command, i);
+		ASSERT_EQ(params.count(), 1);
+		ASSERT_EQ(params[0].toUInt(), i);
+	}
+}
+
+TEST_F(IPCTest, SemaphoreModePriority)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_SEMAPHORE);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_SEMAPHORE);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	for (quint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_TRUE(slave.send(i, 0));
+	}
+	ASSERT_TRUE(slave.send(1000, 0, QStringList(), MUtils::IPCChannel::PRIORITY_HIGH));
+	ASSERT_TRUE(slave.send(2000, 0, QStringList(), MUtils::IPCChannel::PRIORITY_URGENT));
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_TRUE(master.read(command, flags, params));
+	ASSERT_EQ(command, 2000);
+	ASSERT_TRUE(master.read(command, flags, params));
+	ASSERT_EQ(command, 1000);
+	for (quint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_TRUE(master.read(command, flags, params));
+		ASSERT_EQ(command, i);
+	}
+}
+
+TEST_F(IPCTest, ModeMismatch)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_SEMAPHORE);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_FAILURE);
+}
+
+TEST_F(IPCTest, RingModeLargeMessage)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QStringList input;
+	for (int i = 0; i < 64; ++i)
+	{
+		input << QString(i * 113, QChar(L'A' + (i % 26)));
+	}
+	for (quint32 i = 0; i < 100; ++i)
+	{
+		ASSERT_TRUE(slave.send(i, 0, input));
+		quint32 command, flags;
+		QStringList params;
+		ASSERT_TRUE(master.read(command, flags, params));
+		ASSERT_EQ(command, i);
+		ASSERT_EQ(params.count(), input.count());
+		for (int j = 0; j < input.count(); ++j)
+		{
+			ASSERT_EQ(params[j].compare(input[j]), 0);
+		}
+	}
+}
+
+#define TEST_IPC_BATCH(MODE) do \
+{ \
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, (MODE)); \
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, (MODE)); \
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER); \
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE); \
+	QList<MUtils::IPCChannel::ipc_message_t> batch; \
+	for (quint32 i = 0; i < 100; ++i) \
+	{ \
+		MUtils::IPCChannel::ipc_message_t message; \
+		message.command = i; \
+		message.flags = 0; \
+		message.params << QString::number(i) << QString(TEST_STRING); \
+		batch << message; \
+	} \
+	ASSERT_TRUE(slave.sendBatch(batch)); \
+	quint32 next = 0; \
+	while (next < 100) \
+	{ \
+		if (next % 2) \
+		{ \
+			quint32 command, flags; \
+			QStringList params; \
+			ASSERT_TRUE(master.read(command, flags, params)); \
+			ASSERT_EQ(command, next++); \
+			continue; \
+		} \
+		QList<MUtils::IPCChannel::ipc_message_t> messages; \
+		ASSERT_TRUE(master.readBatch(messages, 7)); \
+		ASSERT_GE(messages.count(), 1); \
+		ASSERT_LE(messages.count(), 7); \
+		for (int j = 0; j < messages.count(); ++j) \
+		{ \
+			ASSERT_EQ(messages[j].command, next); \
+			ASSERT_EQ(messages[j].params.count(), 2); \
+			ASSERT_EQ(messages[j].params[0].toUInt(), next++); \
+			ASSERT_QSTR(messages[j].params[1], TEST_STRING); \
+		} \
+	} \
+} \
+while(0)
+
+TEST_F(IPCTest, SemaphoreModeBatch)
+{
+	TEST_IPC_BATCH(MUtils::IPCChannel::MODE_SEMAPHORE);
+}
+
+TEST_F(IPCTest, RingModeBatch)
+{
+	TEST_IPC_BATCH(MUtils::IPCChannel::MODE_RING);
+}
+
+TEST_F(IPCTest, RingModeBatchInvalid)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QList<MUtils::IPCChannel::ipc_message_t> batch;
+	for (quint32 i = 0; i < 3; ++i)
+	{
+		MUtils::IPCChannel::ipc_message_t message;
+		message.command = i;
+		message.flags = 0;
+		message.params << ((i == 2) ? QString(1048576, QLatin1Char('x')) : QString(TEST_STRING));
+		batch << message;
+	}
+	ASSERT_FALSE(slave.sendBatch(batch)); /*the last message is too large*/
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_FALSE(master.tryRead(command, flags, params));
+}
+
+#define TEST_IPC_TIMED(MODE) do \
+{ \
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, (MODE)); \
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, (MODE)); \
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER); \
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE); \
+	quint32 command, flags; \
+	QStringList params; \
+	ASSERT_FALSE(master.tryRead(command, flags, params)); \
+	ASSERT_FALSE(master.read(command, flags, params, 50)); \
+	ASSERT_TRUE(slave.send(42, 0, QStringList() << QString(TEST_STRING))); \
+	ASSERT_TRUE(master.tryRead(command, flags, params)); \
+	ASSERT_EQ(command, 42); \
+	ASSERT_EQ(params.count(), 1); \
+	ASSERT_QSTR(params[0], TEST_STRING); \
+	ASSERT_TRUE(slave.send(43, 0)); \
+	ASSERT_TRUE(master.read(command, flags, params, 50)); \
+	ASSERT_EQ(command, 43); \
+	ASSERT_EQ(params.count(), 0); \
+	ASSERT_FALSE(master.tryRead(command, flags, params)); \
+} \
+while(0)
+
+TEST_F(IPCTest, SemaphoreModeTimedRead)
+{
+	TEST_IPC_TIMED(MUtils::IPCChannel::MODE_SEMAPHORE);
+}
+
+TEST_F(IPCTest, RingModeTimedRead)
+{
+	TEST_IPC_TIMED(MUtils::IPCChannel::MODE_RING);
+}
+
+static bool wait_for_timers(const QTimer &timer1, const QTimer &timer2, const quint32 timeout)
+{
+	const DWORD startTime = GetTickCount();
+	while (!(timer1.isActive() && timer2.isActive()))
+	{
+		if ((GetTickCount() - startTime) > timeout)
+		{
+			return false;
+		}
+		QCoreApplication::processEvents();
+		Sleep(1);
+	}
+	return true;
+}
+
+TEST_F(IPCTest, RingModeNotifier)
+{
+	int argc = 1;
+	char argv0[] = "MUtilsTest", *argv[] = { argv0, NULL };
+	QScopedPointer<QCoreApplication> application(QCoreApplication::instance() ? NULL : new QCoreApplication(argc, argv));
+	QScopedPointer<MUtils::IPCNotifier> notifier1, notifier2;
+	{
+		MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+		MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+		ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+		ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+		notifier1.reset(new MUtils::IPCNotifier(master));
+		notifier2.reset(new MUtils::IPCNotifier(master));
+		QTimer timer1, timer2;
+		timer1.setInterval(60000);
+		timer2.setInterval(60000);
+		QObject::connect(notifier1.data(), SIGNAL(messagesPending()), &timer1, SLOT(start()));
+		QObject::connect(notifier2.data(), SIGNAL(messagesPending()), &timer2, SLOT(start()));
+		ASSERT_TRUE(slave.send(42, 0));
+		ASSERT_TRUE(slave.send(43, 0));
+		ASSERT_TRUE(wait_for_timers(timer1, timer2, 5000)); /*both notifiers must be signalled*/
+		timer1.stop();
+		timer2.stop();
+		quint32 command, flags;
+		QStringList params;
+		ASSERT_TRUE(master.tryRead(command, flags, params));
+		ASSERT_EQ(command, 42);
+		ASSERT_TRUE(wait_for_timers(timer1, timer2, 5000)); /*one message is still pending*/
+		ASSERT_TRUE(master.tryRead(command, flags, params));
+		ASSERT_EQ(command, 43);
+	}
+	notifier1.reset(); /*the channel has already been destroyed*/
+	notifier2.reset();
+}
+
+TEST_F(IPCTest, RingModeView)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	ASSERT_TRUE(slave.send(42, 7, QStringList() << QString("foo") << QString() << QString(TEST_STRING)));
+	MUtils::IPCMessageView view;
+	ASSERT_TRUE(master.readView(view, 50));
+	ASSERT_TRUE(view.isValid());
+	ASSERT_EQ(view.command(), 42);
+	ASSERT_EQ(view.flags(), 7);
+	ASSERT_EQ(view.paramCount(), 3);
+	quint32 length;
+	const char *const param_2 = view.param(2, length);
+	ASSERT_QSTR(QString::fromUtf8(param_2, int(length)), TEST_STRING);
+	const char *const param_0 = view.param(0, length);
+	ASSERT_EQ(length, 3);
+	ASSERT_EQ(memcmp(param_0, "foo", 3), 0);
+	ASSERT_TRUE(view.param(1, length) != NULL);
+	ASSERT_EQ(length, 0);
+	ASSERT_TRUE(view.param(3, length) == NULL);
+	view.release();
+	ASSERT_FALSE(view.isValid());
+	ASSERT_FALSE(master.readView(view, 0));
+}
+
+TEST_F(IPCTest, BroadcastMode)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_BROADCAST);
+	MUtils::IPCChannel slave1("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_BROADCAST);
+	MUtils::IPCChannel slave2("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_BROADCAST);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave1.initialize(), MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	ASSERT_EQ(slave2.initialize(), MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	ASSERT_TRUE(master.send(42, 0, QStringList() << QString(TEST_STRING)));
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_TRUE(slave1.read(command, flags, params, 50));
+	ASSERT_EQ(command, 42);
+	ASSERT_EQ(params.count(), 1);
+	ASSERT_QSTR(params[0], TEST_STRING);
+	ASSERT_TRUE(slave2.read(command, flags, params, 50));
+	ASSERT_EQ(command, 42);
+	ASSERT_QSTR(params[0], TEST_STRING);
+	ASSERT_FALSE(slave1.tryRead(command, flags, params));
+	ASSERT_FALSE(master.tryRead(command, flags, params));
+}
+
+TEST_F(IPCTest, BroadcastModeSlowSubscriber)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_BROADCAST);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_BROADCAST);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	for(quint32 i = 0; i < 5000; ++i)
+	{
+		ASSERT_TRUE(master.send(i, 0));
+	}
+	quint32 command, flags, last, count = 0;
+	QStringList params;
+	ASSERT_TRUE(slave.tryRead(command, flags, params));
+	ASSERT_GT(command, 0U);
+	last = command;
+	while(slave.tryRead(command, flags, params))
+	{
+		last = command;
+		count++;
+	}
+	ASSERT_EQ(last, 4999);
+	ASSERT_LT(count, 5000U);
+}
+
+TEST_F(IPCTest, PipeMode)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_PIPE);
+	MUtils::IPCChannel slave1("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_PIPE);
+	MUtils::IPCChannel slave2("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_PIPE);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave1.initialize(), MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	ASSERT_EQ(slave2.initialize(), MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	ASSERT_TRUE(slave1.send(42, 0, QStringList() << QString(TEST_STRING)));
+	ASSERT_TRUE(slave2.send(43, 0, QStringList() << QString(TEST_STRING)));
+	QList<MUtils::IPCChannel::ipc_message_t> messages;
+	while(messages.count() < 2)
+	{
+		QList<MUtils::IPCChannel::ipc_message_t> current;
+		ASSERT_TRUE(master.readBatch(current, 2));
+		messages.append(current);
+	}
+	ASSERT_EQ(messages[0].command + messages[1].command, 85U);
+	ASSERT_QSTR(messages[0].params[0], TEST_STRING);
+	ASSERT_QSTR(messages[1].params[0], TEST_STRING);
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_FALSE(master.tryRead(command, flags, params));
+	ASSERT_ANY_THROW(master.send(44, 0));
+	ASSERT_ANY_THROW(slave1.tryRead(command, flags, params));
+}
+
+TEST_F(IPCTest, PipeModeHandle)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_PIPE);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_PIPE);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	const HANDLE event = CreateEventW(NULL, TRUE, FALSE, NULL);
+	ASSERT_TRUE(event != NULL);
+	ASSERT_TRUE(slave.sendHandle(42, 0, QStringList(), event));
+	quint32 command, flags;
+	QStringList params;
+	void *handle;
+	ASSERT_TRUE(master.readHandle(command, flags, params, handle));
+	ASSERT_EQ(command, 42);
+	ASSERT_TRUE(handle != NULL);
+	ASSERT_TRUE(handle != event);
+	ASSERT_TRUE(SetEvent(handle));
+	ASSERT_EQ(WaitForSingleObject(event, 0), WAIT_OBJECT_0);
+	CloseHandle(handle);
+	ASSERT_TRUE(slave.send(43, 0));
+	ASSERT_TRUE(master.readHandle(command, flags, params, handle));
+	ASSERT_EQ(command, 43);
+	ASSERT_TRUE(handle == NULL); /*no handle has been passed*/
+	DWORD before = 0, after = 0;
+	ASSERT_TRUE(GetProcessHandleCount(GetCurrentProcess(), &before));
+	ASSERT_TRUE(slave.sendHandle(44, 0, QStringList(), event));
+	ASSERT_TRUE(master.read(command, flags, params));
+	ASSERT_EQ(command, 44);
+	ASSERT_TRUE(GetProcessHandleCount(GetCurrentProcess(), &after));
+	ASSERT_EQ(after, before); /*a handle that nobody asked for must be closed*/
+	CloseHandle(event);
+}
+
+TEST_F(IPCTest, PayloadEncode)
+{
+	MUtils::IPCPayload payload;
+	payload.putInt(-1);
+	payload.putInt(Q_INT64_C(0x7FFFFFFFFFFFFFFF));
+	payload.putDouble(3.25);
+	payload.putBytes(QByteArray("\0\1\2", 3));
+	payload.putStrings(QStringList() << QString(TEST_STRING) << QString());
+	MUtils::IPCPayload decoded(payload.data());
+	qint64 intValue;
+	double doubleValue;
+	QByteArray bytesValue;
+	QStringList stringsValue;
+	ASSERT_FALSE(decoded.getDouble(doubleValue));
+	ASSERT_TRUE(decoded.getInt(intValue));
+	ASSERT_EQ(intValue, -1);
+	ASSERT_TRUE(decoded.getInt(intValue));
+	ASSERT_EQ(intValue, Q_INT64_C(0x7FFFFFFFFFFFFFFF));
+	ASSERT_EQ(decoded.nextType(), MUtils::IPCPayload::TYPE_DOUBLE);
+	ASSERT_TRUE(decoded.getDouble(doubleValue));
+	ASSERT_EQ(doubleValue, 3.25);
+	ASSERT_TRUE(decoded.getBytes(bytesValue));
+	ASSERT_TRUE(bytesValue == QByteArray("\0\1\2", 3));
+	ASSERT_TRUE(decoded.getStrings(stringsValue));
+	ASSERT_EQ(stringsValue.count(), 2);
+	ASSERT_QSTR(stringsValue[0], TEST_STRING);
+	ASSERT_TRUE(stringsValue[1].isEmpty());
+	ASSERT_EQ(decoded.nextType(), MUtils::IPCPayload::TYPE_NONE);
+	MUtils::IPCPayload truncated(payload.data().left(payload.data().size() - 1));
+	ASSERT_TRUE(truncated.getInt(intValue));
+	ASSERT_TRUE(truncated.getInt(intValue));
+	ASSERT_TRUE(truncated.getDouble(doubleValue));
+	ASSERT_TRUE(truncated.getBytes(bytesValue));
+	ASSERT_FALSE(truncated.getStrings(stringsValue));
+	ASSERT_EQ(truncated.nextType(), MUtils::IPCPayload::TYPE_NONE);
+}
+
+TEST_F(IPCTest, RingModePayload)
+{
+	MUtils::IPCChannel master("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	MUtils::IPCChannel slave ("mutilities_test", 1, m_channelId, MUtils::IPCChannel::MODE_RING);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	MUtils::IPCPayload payload;
+	payload.putInt(1234567890123LL);
+	payload.putStrings(QStringList() << QString(TEST_STRING));
+	ASSERT_TRUE(slave.sendPayload(42, 7, payload));
+	ASSERT_TRUE(slave.send(43, 0));
+	quint32 command, flags;
+	MUtils::IPCPayload received;
+	ASSERT_TRUE(master.readPayload(command, flags, received));
+	ASSERT_EQ(command, 42);
+	ASSERT_EQ(flags, 7);
+	qint64 intValue;
+	QStringList stringsValue;
+	ASSERT_TRUE(received.getInt(intValue));
+	ASSERT_EQ(intValue, 1234567890123LL);
+	ASSERT_TRUE(received.getStrings(stringsValue));
+	ASSERT_QSTR(stringsValue[0], TEST_STRING);
+	ASSERT_FALSE(master.readPayload(command, flags, received, 0)); /*the next message is untyped*/
+	ASSERT_TRUE(master.tryRead(command, flags, stringsValue));
+	ASSERT_EQ(command, 43);
+	ASSERT_TRUE(slave.send(44, 0));
+	ASSERT_TRUE(slave.sendPayload(45, 0, payload));
+	ASSERT_TRUE(master.readPayload(command, flags, received, 0));
+	ASSERT_EQ(command, 45);
+	ASSERT_TRUE(master.tryRead(command, flags, stringsValue));
+	ASSERT_EQ(command, 44);
+	ASSERT_FALSE(master.readPayload(command, flags, received, 0));
+	ASSERT_FALSE(master.tryRead(command, flags, stringsValue));
+}
+
+TEST_F(IPCTest, StreamBlob)
+{
+	MUtils::IPCStream master("mutilities_test", 1, m_channelId);
+	MUtils::IPCStream slave ("mutilities_test", 1, m_channelId);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QByteArray blob(int(MUtils::IPCStream::CHUNK_SIZE * 3U) + 4321, '\0');
+	for(int i = 0; i < blob.size(); ++i)
+	{
+		blob[i] = char(MUtils::next_rand_u32() & 0xFF);
+	}
+	ASSERT_TRUE(slave.write(42, blob));
+	ASSERT_TRUE(slave.write(43, QByteArray()));
+	quint32 tag;
+	QByteArray data;
+	ASSERT_TRUE(master.read(tag, data));
+	ASSERT_EQ(tag, 42);
+	ASSERT_TRUE(data == blob);
+	ASSERT_TRUE(master.read(tag, data));
+	ASSERT_EQ(tag, 43);
+	ASSERT_TRUE(data.isEmpty());
+}
+
+TEST_F(IPCTest, StreamDevice)
+{
+	MUtils::IPCStream master("mutilities_test", 1, m_channelId);
+	MUtils::IPCStream slave ("mutilities_test", 1, m_channelId);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QByteArray blob(int(MUtils::IPCStream::CHUNK_SIZE * 2U), 'x');
+	QBuffer input(&blob), output;
+	ASSERT_TRUE(input.open(QIODevice::ReadOnly));
+	ASSERT_TRUE(output.open(QIODevice::WriteOnly));
+	ASSERT_TRUE(slave.write(7, input));
+	quint32 tag;
+	ASSERT_TRUE(master.read(tag, output));
+	ASSERT_EQ(tag, 7);
+	ASSERT_TRUE(output.data() == blob);
+}
+
+/*
+ * Sequential device that delivers its data in small pieces and has *no* data available between two pieces, like a QProcess
+ */
+class StutterDevice : public QIODevice
+{
+public:
+	StutterDevice(const QByteArray &data) : m_data(data), m_pos(0), m_ready(true) { }
+	virtual bool isSequential(void) const { return true; }
+	virtual bool waitForReadyRead(int) { m_ready = true; return (m_pos < m_data.size()); }
+
+protected:
+	virtual qint64 readData(char *data, qint64 maxlen)
+	{
+		if((!m_ready) || (m_pos >= m_data.size()))
+		{
+			return 0;
+		}
+		const int count = int(qMin(maxlen, qint64(qMin(1000, m_data.size() - m_pos))));
+		memcpy(data, m_data.constData() + m_pos, size_t(count));
+		m_pos += count;
+		m_ready = false;
+		return count;
+	}
+	virtual qint64 writeData(const char*, qint64) { return -1; }
+
+private:
+	const QByteArray m_data;
+	int m_pos;
+	bool m_ready;
+};
+
+TEST_F(IPCTest, StreamSequential)
+{
+	MUtils::IPCStream master("mutilities_test", 1, m_channelId);
+	MUtils::IPCStream slave ("mutilities_test", 1, m_channelId);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QByteArray blob(int(MUtils::IPCStream::CHUNK_SIZE) + 4321, '\0');
+	for(int i = 0; i < blob.size(); ++i)
+	{
+		blob[i] = char(MUtils::next_rand_u32() & 0xFF);
+	}
+	StutterDevice input(blob);
+	ASSERT_TRUE(input.open(QIODevice::ReadOnly | QIODevice::Unbuffered));
+	ASSERT_TRUE(slave.write(7, input));
+	quint32 tag;
+	QByteArray data;
+	ASSERT_TRUE(master.read(tag, data));
+	ASSERT_EQ(tag, 7);
+	ASSERT_TRUE(data == blob); /*must not be truncated at the first short read*/
+}
+
+TEST_F(IPCTest, CacheShared)
+{
+	MUtils::IPCCache master("mutilities_test", 1, m_channelId);
+	MUtils::IPCCache slave ("mutilities_test", 1, m_channelId);
+	ASSERT_EQ(master.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_EQ(slave.initialize(),  MUtils::IPCChannel::RET_SUCCESS_SLAVE);
+	QByteArray value;
+	ASSERT_FALSE(master.lookup("foo", value));
+	ASSERT_TRUE(slave.insert("foo", TEST_STRING));
+	ASSERT_TRUE(master.lookup("foo", value));
+	ASSERT_TRUE(value == QByteArray(TEST_STRING));
+	ASSERT_TRUE(master.insert("foo", "bar"));
+	ASSERT_TRUE(slave.lookup("foo", value));
+	ASSERT_TRUE(value == QByteArray("bar"));
+	ASSERT_TRUE(slave.remove("foo"));
+	ASSERT_FALSE(master.lookup("foo", value));
+	ASSERT_FALSE(master.remove("foo"));
+	ASSERT_FALSE(master.insert(QByteArray(), "bar"));
+	ASSERT_FALSE(master.insert("foo", QByteArray(int(MUtils::IPCCache::MAX_VALUE_LEN) + 1, 'x')));
+}
+
+TEST_F(IPCTest, CacheEviction)
+{
+	MUtils::IPCCache cache("mutilities_test", 1, m_channelId);
+	ASSERT_EQ(cache.initialize(), MUtils::IPCChannel::RET_SUCCESS_MASTER);
+	ASSERT_TRUE(cache.insert("hot", "1"));
+	ASSERT_TRUE(cache.insert("cold", "2"));
+	QByteArray value;
+	for(quint32 i = 0; i < 4U * MUtils::IPCCache::BUCKET_COUNT; ++i)
+	{
+		ASSERT_TRUE(cache.insert(QByteArray::number(i), QByteArray::number(i)));
+		ASSERT_TRUE(cache.lookup("hot", value));
+	}
+	ASSERT_FALSE(cache.lookup("cold", value));
+	quint32 count = 0;
+	for(quint32 i = 0; i < 4U * MUtils::IPCCache::BUCKET_COUNT; ++i)
+	{
+		if(cache.lookup(QByteArray::number(i), value))
+		{
+			ASSERT_TRUE(value == QByteArray::number(i));
+			count++;
+		}
+	}
+	ASSERT_LT(count, MUtils::IPCCache::BUCKET_COUNT);
+	ASSERT_TRUE(cache.lookup("hot", value));
+	ASSERT_TRUE(value == QByteArray("1"));
+}
+
+TEST_F(IPCTest, WorkerFarm)
+{
+	MUtils::WorkerFarm farm("mutilities_test", 1, 3);
+	ASSERT_TRUE(farm.start());
+	QHash<quint32, QByteArray> expected;
+	for (quint32 i = 0; i < 250; ++i)
+	{
+		const QByteArray input = QByteArray::number(i);
+		const quint32 jobId = farm.submit(input);
+		ASSERT_GT(jobId, 0U);
+		expected.insert(jobId, input.toHex());
+	}
+	MUtils::WorkerFarm::farm_result_t result;
+	while (farm.collect(result))
+	{
+		ASSERT_TRUE(result.success);
+		ASSERT_TRUE(expected.contains(result.jobId));
+		ASSERT_TRUE(expected.take(result.jobId) == result.output);
+	}
+	ASSERT_TRUE(expected.isEmpty());
+	ASSERT_EQ(farm.pending(), 0U);
+}
+
+TEST_F(IPCTest, WorkerFarmCrash)
+{
+	MUtils::WorkerFarm farm("mutilities_test", 1, 2);
+	ASSERT_TRUE(farm.start());
+	const quint32 crashJob = farm.submit("crash");
+	ASSERT_GT(crashJob, 0U);
+	for (quint32 i = 0; i < 10; ++i)
+	{
+		ASSERT_GT(farm.submit(QByteArray::number(i)), 0U);
+	}
+	quint32 succeeded = 0, failed = 0;
+	MUtils::WorkerFarm::farm_result_t result;
+	while (farm.collect(result))
+	{
+		if (result.jobId == crashJob)
+		{
+			ASSERT_FALSE(result.success);
+			failed++;
+		}
+		else
+		{
+			ASSERT_TRUE(result.success);
+			succeeded++;
+		}
+	}
+	ASSERT_EQ(failed, 1U);
+	ASSERT_EQ(succeeded, 10U);
+}
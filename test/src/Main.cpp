@@ -25,11 +25,16 @@
 //MUtils
 #include <MUtils/Global.h>
 #include <MUtils/Version.h>
+#include <MUtils/WorkerFarm.h>
 
 //CRT
 #include <cstdio>
 #include <cstdlib>
 
+//Win32
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+
 //===========================================================================
 // Message Handler
 //===========================================================================
@@ -96,12 +101,31 @@ static void qt_message_handler(QtMsgType type, const char *const msg)
 	}
 }
 
+//===========================================================================
+// Worker function
+//===========================================================================
+
+static bool test_worker_function(const QByteArray &input, QByteArray &output, void *const)
+{
+	if (input == "crash")
+	{
+		TerminateProcess(GetCurrentProcess(), 42);
+	}
+	output = input.toHex();
+	return (!input.isEmpty());
+}
+
 //===========================================================================
 // Main function
 //===========================================================================
 
 int wmain(int argc, wchar_t **argv)
 {
+	if (MUtils::WorkerFarm::isWorker())
+	{
+		return MUtils::WorkerFarm::runWorker("mutilities_test", 1, test_worker_function);
+	}
+
 	printf("MuldeR's Utilities for Qt v%u.%02u - Regression Test Suite [%s]\n", MUtils::Version::lib_version_major(), MUtils::Version::lib_version_minor(), MUTILS_DEBUG ? "DEBUG" : "RELEASE");
 	printf("Copyright (C) 2004-2026 LoRd_MuldeR <MuldeR2@GMX.de>. Some rights reserved.\n");
 	printf("Built on %s at %s with %s for Win-%s.\n\n", MUTILS_UTF8(MUtils::Version::lib_build_date().toString(Qt::ISODate)), MUTILS_UTF8(MUtils::Version::lib_build_time().toString(Qt::ISODate)), MUtils::Version::compiler_version(), MUtils::Version::compiler_arch());